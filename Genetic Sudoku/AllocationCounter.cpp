@@ -0,0 +1,59 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+//Zero-initialized before anything runs, so allocations made during static initialization are counted too
+static std::atomic<long long> allocationCount;
+
+long long getAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+//A relaxed increment is all counting costs, every other operator new and delete ends up in these
+void *operator new(size_t size)
+{
+	void *memory;
+
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	memory = malloc(size ? size : 1);
+	if(!memory)
+		throw std::bad_alloc();
+
+	return memory;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *memory)
+{
+	free(memory);
+}
+
+void operator delete[](void *memory)
+{
+	free(memory);
+}
+
+//C++14 compilers call the sized forms when they know the size, they have to free from the same heap as the unsized ones
+void operator delete(void *memory, size_t)
+{
+	free(memory);
+}
+
+void operator delete[](void *memory, size_t)
+{
+	free(memory);
+}
+
+#else
+
+long long getAllocationCount()
+{
+	return -1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+//Builds that define COUNT_ALLOCATIONS send every heap allocation through the replacement operator new in AllocationCounter.cpp, which counts them
+//	The benchmark uses the count to check that a population's generations stop allocating once it has warmed up
+//	Other builds keep the standard allocator, so sanitizers and normal solver runs see the real one
+long long getAllocationCount();			//Allocations made so far, by every thread, or -1 if the build doesn't count them
\ No newline at end of file
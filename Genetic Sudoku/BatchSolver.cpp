@@ -0,0 +1,151 @@
+#include "BatchSolver.h"
+
+//Puzzles are solved side by side, so they'd all be exporting their metrics over one another
+BatchSolver::BatchSolver(const SolverConfig &solverConfig) : config(solverConfig), scheduler(solverConfig.numThreads, solverConfig.pinThreads)
+{
+	config.metricsPath.clear();
+}
+
+//Files are memory-mapped and parsed in place, only stdin has to be read into memory first
+bool BatchSolver::loadPuzzles(const char *path)
+{
+	std::vector<std::vector<int>> boards;
+
+	if(strcmp(path, "-") == 0)
+	{
+		boards = parsePuzzleStream(std::cin);
+		addPuzzles(boards, "stdin");
+		return true;
+	}
+	if(loadDirectory(path))
+		return true;
+
+	if(!parsePuzzleFile(path, boards))
+	{
+		std::cerr << "Could not open batch: " << path << std::endl;
+		return false;
+	}
+	addPuzzles(boards, path);
+
+	return true;
+}
+
+//Loads every file in a directory (not recursively), in name order so a batch always runs the same way
+bool BatchSolver::loadDirectory(const char *path)
+{
+	std::vector<std::string> fileNames;
+	std::vector<std::vector<int>> boards;
+
+	if(!listDirectory(path, fileNames))
+		return false;
+
+	for(int i = 0; i < fileNames.size(); i++)
+	{
+		boards.clear();
+		if(parsePuzzleFile(fileNames[i].c_str(), boards))
+			addPuzzles(boards, fileNames[i]);
+	}
+
+	return true;
+}
+
+void BatchSolver::addPuzzles(std::vector<std::vector<int>> &boards, const std::string &name)
+{
+	puzzles.reserve(puzzles.size() + boards.size());
+	for(int i = 0; i < boards.size(); i++)
+	{
+		puzzles.push_back(BatchPuzzle());
+		puzzles.back().name = name;
+		if(boards.size() > 1)
+			puzzles.back().name += "#" + std::to_string((long long) i + 1);
+		puzzles.back().initialBoard.swap(boards[i]);
+	}
+}
+
+//Keeps concurrentPuzzles solves going at once until the batch runs out, reporting each one as it finishes
+int BatchSolver::run()
+{
+	std::vector<std::unique_ptr<PopulationCongregator>> slots;	//The solves currently in flight
+	std::vector<int> slotPuzzle;								//Which puzzle each slot is solving
+	std::vector<int> finished;
+	RandomGenerator random(config.seed);
+	SolverConfig puzzleConfig;
+	int nextPuzzle;
+	int reported;
+	int solved;
+	long long elapsed;
+	std::chrono::high_resolution_clock::time_point startTime;
+
+	slots.resize(config.concurrentPuzzles);
+	slotPuzzle.assign(config.concurrentPuzzles, -1);
+	puzzleConfig = config;
+	nextPuzzle = 0;
+	reported = 0;
+	solved = 0;
+
+	std::cout << "Solving " << puzzles.size() << " puzzles, " << config.concurrentPuzzles << " at a time with " << config.numIslands << " islands each on " << config.numThreads << " threads... " << std::endl;
+	startTime = std::chrono::high_resolution_clock::now();
+
+	while(reported < puzzles.size())
+	{
+		//Start a new solve in every free slot
+		for(int slot = 0; slot < slots.size(); slot++)
+		{
+			while(!slots[slot] && (nextPuzzle < puzzles.size()))
+			{
+				if(!PuzzleDefinition::isValidShape(puzzles[nextPuzzle].initialBoard))
+				{
+					std::cout << puzzles[nextPuzzle].name << ": not a valid Sudoku Puzzle, skipped" << std::endl;
+					nextPuzzle++;
+					reported++;
+					continue;
+				}
+
+				puzzleConfig.seed = random.next();	//Every puzzle gets its own seed, so the batch as a whole is reproducible
+				slots[slot].reset(new PopulationCongregator(std::make_shared<PuzzleDefinition>(puzzles[nextPuzzle].initialBoard), puzzleConfig, scheduler));
+				slotPuzzle[slot] = nextPuzzle++;
+				slots[slot]->start([this, slot]
+				{
+					std::lock_guard<std::mutex> lock(finishedMutex);
+					finishedSlots.push_back(slot);
+					puzzleFinished.notify_one();
+				});
+			}
+		}
+
+		//Nothing left in flight (the rest were skipped)
+		if(reported == puzzles.size())
+			break;
+
+		{
+			std::unique_lock<std::mutex> lock(finishedMutex);
+			puzzleFinished.wait(lock, [this] { return !finishedSlots.empty(); });
+			finished.swap(finishedSlots);
+		}
+
+		for(int i = 0; i < finished.size(); i++)
+		{
+			PopulationCongregator &congregator = *slots[finished[i]];
+
+			std::cout << puzzles[slotPuzzle[finished[i]]].name << ": ";
+			if(congregator.isSolved())
+			{
+				std::cout << "solved in " << congregator.getElapsedMilliseconds() << " ms (" << congregator.getGenerations() << " generations)" << std::endl;
+				solved++;
+			}
+			else if(congregator.isBudgetExpired())
+				std::cout << "ran out of budget at fitness " << congregator.getBest().getFitness() << " after " << congregator.getElapsedMilliseconds() << " ms" << std::endl;
+			else
+				std::cout << "stopped at fitness " << congregator.getBest().getFitness() << " after " << congregator.getElapsedMilliseconds() << " ms" << std::endl;
+
+			slots[finished[i]].reset();
+			reported++;
+		}
+		finished.clear();
+	}
+
+	elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+	std::cout << "Solved " << solved << " of " << puzzles.size() << " puzzles in " << elapsed << " ms (" << (solved * 1000.0 / std::max(elapsed, 1LL)) << " puzzles/second)" << std::endl;
+
+	return (solved == puzzles.size()) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PopulationCongregator.h"
+
+//A puzzle waiting to be solved as part of a batch
+struct BatchPuzzle
+{
+	std::string name;				//File it came from (plus its position, for files holding several puzzles)
+	std::vector<int> initialBoard;
+};
+
+//Solves a whole batch of puzzles in one process
+//	Every puzzle gets its own PopulationCongregator, and several of them are solved at once on a single shared TaskScheduler,
+//	so the threads are never waiting on any one puzzle. Results are reported as each puzzle finishes
+class BatchSolver
+{
+private:
+	SolverConfig config;
+	TaskScheduler scheduler;			//Shared by every puzzle in the batch
+	std::vector<BatchPuzzle> puzzles;
+	std::mutex finishedMutex;
+	std::condition_variable puzzleFinished;		//Signalled whenever some solve finishes
+	std::vector<int> finishedSlots;				//Slots whose solve has finished but hasn't been reported yet
+
+	bool loadDirectory(const char *);
+	void addPuzzles(std::vector<std::vector<int>> &, const std::string &);	//Takes the boards of a file (or stream) as puzzles named after it
+public:
+	BatchSolver(const SolverConfig &);
+
+	bool loadPuzzles(const char *);		//A directory (every file in it), a file of puzzles (see parsePuzzleText), or - for stdin
+	int run();							//Solves every loaded puzzle, 0 if they were all solved
+};
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "Benchmark.h"
+
+//Calls operation(i) for i = 0, 1, ... and returns the nanoseconds each call took on average
+//	The iterations double until a measurement is long enough for the clock (and a few stray interrupts) not to matter
+template<typename Operation>
+static double timeOperation(Operation operation)
+{
+	std::chrono::high_resolution_clock::time_point startTime;
+	long long elapsed;
+
+	for(long long iterations = 1; ; iterations *= 2)
+	{
+		startTime = std::chrono::high_resolution_clock::now();
+		for(long long i = 0; i < iterations; i++)
+			operation(i);
+		elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		if(elapsed >= microBenchmarkMilliseconds * 1000000LL)
+			return (double) elapsed / iterations;
+	}
+}
+
+//A random order of the n lines (rows or columns) of a board that keeps every band of sizeOfMacroBlock lines together
+static std::vector<int> shuffleLines(int sizeOfMacroBlock, RandomGenerator &random)
+{
+	std::vector<int> bands(sizeOfMacroBlock);
+	std::vector<int> lines;
+	std::vector<int> withinBand(sizeOfMacroBlock);
+
+	for(int i = 0; i < sizeOfMacroBlock; i++)
+		bands[i] = i;
+	std::shuffle(bands.begin(), bands.end(), random);
+
+	for(int i = 0; i < sizeOfMacroBlock; i++)
+	{
+		for(int j = 0; j < sizeOfMacroBlock; j++)
+			withinBand[j] = j;
+		std::shuffle(withinBand.begin(), withinBand.end(), random);
+		for(int j = 0; j < sizeOfMacroBlock; j++)
+			lines.push_back(bands[i] * sizeOfMacroBlock + withinBand[j]);
+	}
+
+	return lines;
+}
+
+Benchmark::Benchmark(const SolverConfig &solverConfig) : config(solverConfig), scheduler(solverConfig.numThreads, solverConfig.pinThreads)
+{
+}
+
+void Benchmark::addPuzzle(const std::string &name, std::vector<int> &board)
+{
+	puzzles.push_back(BenchmarkPuzzle());
+	puzzles.back().name = name;
+	puzzles.back().initialBoard.swap(board);
+	puzzles.back().solved = 0;
+	puzzles.back().generations = 0;
+	puzzles.back().evaluations = 0;
+}
+
+//Puzzles that aren't valid are left out, the rest of the corpus is still worth measuring
+bool Benchmark::loadCorpus(const char *path)
+{
+	std::vector<std::string> fileNames;
+	std::vector<std::vector<int>> boards;
+
+	if(!listDirectory(path, fileNames))
+	{
+		std::cerr << "Could not open benchmark corpus: " << path << std::endl;
+		return false;
+	}
+
+	for(int i = 0; i < fileNames.size(); i++)
+	{
+		boards.clear();
+		if(!parsePuzzleFile(fileNames[i].c_str(), boards))
+			continue;
+
+		for(int j = 0; j < boards.size(); j++)
+		{
+			if(!PuzzleDefinition::isValidShape(boards[j]))
+			{
+				std::cout << fileNames[i] << ": not a valid Sudoku Puzzle, skipped" << std::endl;
+				continue;
+			}
+			addPuzzle((boards.size() > 1) ? fileNames[i] + "#" + std::to_string((long long) j + 1) : fileNames[i], boards[j]);
+		}
+	}
+
+	return true;
+}
+
+void Benchmark::generatePuzzles()
+{
+	RandomGenerator random(benchmarkPuzzleSeed);
+	std::vector<int> board;
+
+	for(int i = 0; i < config.benchmarkSizes.size(); i++)
+	{
+		board = generatePuzzle(config.benchmarkSizes[i], config.benchmarkClues, random);
+		addPuzzle("generated " + std::to_string((long long) config.benchmarkSizes[i]) + "x" + std::to_string((long long) config.benchmarkSizes[i]) +
+			" (" + std::to_string((long long) config.benchmarkClues) + "% given)", board);
+	}
+}
+
+//Starts from the pattern solution (every row is the one above it shifted along by a macroBlock, every band by one more), which is
+//	a valid solution for any size, then shuffles it without breaking it (relabelling the numbers, and reordering bands, stacks,
+//	and the rows and columns within them) and blanks out all but cluePercent of the cells
+//	The puzzle always has a solution, though not necessarily just the one, which is all the genetic search needs
+std::vector<int> Benchmark::generatePuzzle(int sizeOfBoard, int cluePercent, RandomGenerator &random)
+{
+	std::vector<int> board(sizeOfBoard * sizeOfBoard);
+	std::vector<int> numbers(sizeOfBoard);
+	std::vector<int> cells(sizeOfBoard * sizeOfBoard);
+	std::vector<int> rows;
+	std::vector<int> cols;
+	int sizeOfMacroBlock;
+	int numGivens;
+
+	sizeOfMacroBlock = (int) (sqrt((double) sizeOfBoard) + 0.5);
+	for(int i = 0; i < sizeOfBoard; i++)
+		numbers[i] = i + 1;
+	std::shuffle(numbers.begin(), numbers.end(), random);
+	rows = shuffleLines(sizeOfMacroBlock, random);
+	cols = shuffleLines(sizeOfMacroBlock, random);
+
+	for(int row = 0; row < sizeOfBoard; row++)
+		for(int col = 0; col < sizeOfBoard; col++)
+			board[convertCoordinates(col, row, sizeOfBoard)] = numbers[(sizeOfMacroBlock * (rows[row] % sizeOfMacroBlock) + rows[row] / sizeOfMacroBlock + cols[col]) % sizeOfBoard];
+
+	//Blanks out a random selection of the cells
+	numGivens = sizeOfBoard * sizeOfBoard * cluePercent / 100;
+	for(int i = 0; i < cells.size(); i++)
+		cells[i] = i;
+	std::shuffle(cells.begin(), cells.end(), random);
+	for(int i = numGivens; i < cells.size(); i++)
+		board[cells[i]] = 0;
+
+	return board;
+}
+
+//The seeds are fixed rather than drawn from config.seed, so two benchmark runs are solving exactly the same searches
+void Benchmark::solvePuzzle(BenchmarkPuzzle &puzzle)
+{
+	SolverConfig runConfig;
+	PuzzleDefinitionPtr definition;
+	std::chrono::high_resolution_clock::time_point startTime;
+	long long elapsed;
+
+	runConfig = config;
+	definition = std::make_shared<PuzzleDefinition>(puzzle.initialBoard);
+
+	for(int seed = 1; seed <= config.benchmarkSeeds; seed++)
+	{
+		runConfig.seed = seed;
+		startTime = std::chrono::high_resolution_clock::now();
+
+		//Setting up the populations is part of the time to solution
+		PopulationCongregator congregator(definition, runConfig, scheduler);
+		congregator.start();
+		if(!congregator.waitFor(config.benchmarkTimeLimit * 1000))
+		{
+			congregator.stop();
+			congregator.wait();
+		}
+		elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		if(congregator.isSolved())
+			puzzle.solved++;
+		else
+			elapsed = config.benchmarkTimeLimit * 1000LL;
+		puzzle.milliseconds.push_back(elapsed);
+		puzzle.generations += congregator.getTotalGenerations();
+		puzzle.evaluations += congregator.getTotalEvaluations();
+	}
+}
+
+//The evaluation rate counts what the islands' workspaces actually evaluated, full boards and single swaps alike, so the
+//	fitness cache and local search show up in it
+void Benchmark::reportPuzzle(const BenchmarkPuzzle &puzzle)
+{
+	long long totalMilliseconds;
+
+	totalMilliseconds = 0;
+	for(int i = 0; i < puzzle.milliseconds.size(); i++)
+		totalMilliseconds += puzzle.milliseconds[i];
+
+	std::cout << puzzle.name << ": solved " << puzzle.solved << "/" << puzzle.milliseconds.size();
+	std::cout << ", p50 " << percentile(puzzle.milliseconds, 50) << " ms, p90 " << percentile(puzzle.milliseconds, 90) << " ms, p99 " << percentile(puzzle.milliseconds, 99) << " ms";
+	std::cout << ", " << puzzle.generations / (long long) puzzle.milliseconds.size() << " generations/run";
+	std::cout << ", " << (long long) (puzzle.evaluations * 1000.0 / std::max(totalMilliseconds, 1LL)) << " evaluations/second" << std::endl;
+}
+
+long long Benchmark::percentile(std::vector<long long> values, int percent)
+{
+	int rank;
+
+	if(values.empty())
+		return 0;
+
+	std::sort(values.begin(), values.end());
+	rank = (int) ((percent * values.size() + 99) / 100);	//Smallest rank that covers percent of the values
+
+	return values[std::max(rank, 1) - 1];
+}
+
+//The puzzle is generated the same way as the benchmark puzzles, and every primitive works on the same specimen
+//	Whatever the primitives compute is added up into sink, so none of the work can be optimized away
+void Benchmark::runMicroBenchmarks(int sizeOfBoard)
+{
+	RandomGenerator random(benchmarkPuzzleSeed);
+	std::vector<int> blocks(1024);
+	std::vector<int> positions(1024);
+	std::vector<int> values(1024);
+	volatile int sink;
+	double evaluateTime;
+	double replaceTime;
+	double randomizeTime;
+	double initTime;
+
+	PuzzleDefinitionPtr definition = std::make_shared<PuzzleDefinition>(generatePuzzle(sizeOfBoard, config.benchmarkClues, random));
+	SudokuPuzzle specimen(definition, random);
+
+	//replaceCell's arguments are drawn up front, so the time is all replaceCell
+	random.fillInts(blocks.data(), (int) blocks.size(), sizeOfBoard);
+	random.fillInts(positions.data(), (int) positions.size(), sizeOfBoard);
+	random.fillInts(values.data(), (int) values.size(), sizeOfBoard);
+	for(int i = 0; i < values.size(); i++)
+		values[i]++;
+	sink = 0;
+
+	evaluateTime = timeOperation([&](long long)
+	{
+		specimen.evaluateFitness();
+		sink += specimen.fitness;
+	});
+	specimen.buildCounts();
+	replaceTime = timeOperation([&](long long i)
+	{
+		specimen.replaceCell(blocks[i & 1023], positions[i & 1023], values[i & 1023]);
+		sink += specimen.fitness;
+	});
+	randomizeTime = timeOperation([&](long long)
+	{
+		specimen.randomize(1, random);
+		sink += specimen.fitness;
+	});
+	initTime = timeOperation([&](long long)
+	{
+		specimen.initCells(random);
+		sink += specimen.board[0];
+	});
+
+	std::cout << sizeOfBoard << "x" << sizeOfBoard << ": evaluateFitness " << evaluateTime << " ns, replaceCell " << replaceTime << " ns, randomize " << randomizeTime << " ns, initCells " << initTime << " ns" << std::endl;
+	runGenerationBenchmark(definition);
+}
+
+//The generations are run on the calling thread, without the scheduler (handing breeders to it allocates its tasks),
+//	and past the point where the puzzle is solved if it comes to that, since an optimal genePool breeds all the same
+void Benchmark::runGenerationBenchmark(PuzzleDefinitionPtr definition)
+{
+	RandomGenerator random(benchmarkPuzzleSeed);
+	std::vector<SudokuPuzzle> initialMembers(1, SudokuPuzzle(definition, random));
+	GeneticPopulation population(initialMembers, config, benchmarkPuzzleSeed);
+	long long generations;
+	long long allocations;
+	double generationTime;
+
+	for(int i = 0; i < benchmarkWarmUpGenerations; i++)
+	{
+		population.spawnChildren();
+		population.improveGenePool();
+	}
+
+	generations = 0;
+	allocations = getAllocationCount();
+	generationTime = timeOperation([&](long long)
+	{
+		population.spawnChildren();
+		population.improveGenePool();
+		generations++;
+	});
+	std::cout << "  generation of " << config.populationSize << " " << generationTime / 1000000 << " ms, ";
+	if(allocations < 0)
+		std::cout << "heap allocations not counted (build with COUNT_ALLOCATIONS)" << std::endl;
+	else
+		std::cout << getAllocationCount() - allocations << " heap allocations in " << generations << " generations" << std::endl;
+}
+
+int Benchmark::run()
+{
+	std::vector<long long> allMilliseconds;
+	int solved;
+	int runs;
+
+	std::cout << "Benchmarking " << puzzles.size() << " puzzles with " << config.benchmarkSeeds << " seeds each, " << config.numIslands << " islands on " << config.numThreads << " threads, "
+		<< config.benchmarkTimeLimit << " s per run..." << std::endl;
+	solved = 0;
+	runs = 0;
+
+	for(int i = 0; i < puzzles.size(); i++)
+	{
+		solvePuzzle(puzzles[i]);
+		reportPuzzle(puzzles[i]);
+
+		allMilliseconds.insert(allMilliseconds.end(), puzzles[i].milliseconds.begin(), puzzles[i].milliseconds.end());
+		solved += puzzles[i].solved;
+		runs += (int) puzzles[i].milliseconds.size();
+	}
+	std::cout << "Overall: solved " << solved << "/" << runs << ", p50 " << percentile(allMilliseconds, 50) << " ms, p90 " << percentile(allMilliseconds, 90) << " ms, p99 " << percentile(allMilliseconds, 99) << " ms" << std::endl;
+
+	std::cout << "Micro-benchmarks (per call):" << std::endl;
+	for(int i = 0; i < config.benchmarkSizes.size(); i++)
+		runMicroBenchmarks(config.benchmarkSizes[i]);
+
+	return (solved == runs) ? 0 : 1;
+}
\ No newline at end of file
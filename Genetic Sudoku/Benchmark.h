@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+#include "PopulationCongregator.h"
+
+//A micro-benchmark keeps doubling its iterations until a measurement takes at least this many milliseconds
+#define microBenchmarkMilliseconds 200
+//Generations a population gets before the ones it runs are timed, and their allocations counted
+#define benchmarkWarmUpGenerations 5
+//Generated puzzles are drawn from a fixed seed, so every benchmark run solves the same ones
+#define benchmarkPuzzleSeed 0x5eed5eedULL
+
+//A puzzle the benchmark solves, along with how its runs went
+struct BenchmarkPuzzle
+{
+	std::string name;
+	std::vector<int> initialBoard;
+	std::vector<long long> milliseconds;	//Time to solution of every run, unsolved runs count as the time limit
+	int solved;
+	long long generations;					//Across every island of every run
+	long long evaluations;					//Fitness evaluations, across every island of every run
+};
+
+//Measures how fast puzzles get solved, so regressions show up and operator settings can be compared on the same footing
+//	Every puzzle (the files of a corpus directory, plus a generated puzzle of each of config.benchmarkSizes) is solved once with each
+//	of the fixed seeds 1 to benchmarkSeeds, one run at a time with all of its islands on the thread pool, and its times to solution
+//	are reported as percentiles. The SudokuPuzzle primitives the genetic operators are built out of are then timed on their own, and
+//	so are whole generations, which once a population has warmed up should make no heap allocations at all
+class Benchmark
+{
+private:
+	SolverConfig config;
+	TaskScheduler scheduler;
+	std::vector<BenchmarkPuzzle> puzzles;
+
+	void addPuzzle(const std::string &, std::vector<int> &);
+	void solvePuzzle(BenchmarkPuzzle &);	//Runs a puzzle once for every seed
+	void reportPuzzle(const BenchmarkPuzzle &);
+	void runMicroBenchmarks(int);			//Times evaluateFitness, replaceCell, randomize and initCells on a generated puzzle of some size
+	void runGenerationBenchmark(PuzzleDefinitionPtr);	//Times a population's generations on a puzzle, and counts the heap allocations they make
+	static long long percentile(std::vector<long long>, int);	//Nearest-rank percentile
+public:
+	Benchmark(const SolverConfig &);
+
+	bool loadCorpus(const char *);			//Every puzzle of every file in a directory
+	void generatePuzzles();					//A puzzle of each of config.benchmarkSizes, with config.benchmarkClues percent of its cells given
+	static std::vector<int> generatePuzzle(int, int, RandomGenerator &);	//Random puzzle of some size with some percent of its cells given
+	int run();								//Solves and reports every puzzle, then runs the micro-benchmarks, 0 if every run was solved
+};
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "BinaryFormat.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+//Reading position in some binary data, every read is bounds checked and just sets failed once the data runs out
+struct ByteReader
+{
+	const unsigned char *position;
+	const unsigned char *end;
+	bool failed;
+};
+
+//Appends a little-endian value to the file being built, the whole file is built in memory and written in one go
+static void writeValue(std::string &bytes, unsigned long long value, int numBytes)
+{
+	for(int i = 0; i < numBytes; i++)
+		bytes.push_back((char) ((value >> (8 * i)) & 0xff));
+}
+
+//Cells go in bitsPerCell bits apiece, lowest bits first, and the board is padded out to a whole byte
+static void writeBoard(std::string &bytes, const Cell *board, int numCells, int bitsPerCell)
+{
+	unsigned int buffer;
+	int bufferedBits;
+
+	buffer = 0;
+	bufferedBits = 0;
+	for(int i = 0; i < numCells; i++)
+	{
+		buffer |= (unsigned int) board[i] << bufferedBits;
+		bufferedBits += bitsPerCell;
+		while(bufferedBits >= 8)
+		{
+			bytes.push_back((char) (buffer & 0xff));
+			buffer >>= 8;
+			bufferedBits -= 8;
+		}
+	}
+	if(bufferedBits > 0)
+		bytes.push_back((char) buffer);
+}
+
+static ByteReader makeReader(const char *begin, const char *end)
+{
+	ByteReader reader;
+
+	reader.position = (const unsigned char *) begin;
+	reader.end = (const unsigned char *) end;
+	reader.failed = false;
+
+	return reader;
+}
+
+static unsigned long long readValue(ByteReader &reader, int numBytes)
+{
+	unsigned long long value;
+
+	value = 0;
+	if(reader.failed || (reader.end - reader.position < numBytes))
+	{
+		reader.failed = true;
+		return 0;
+	}
+	for(int i = 0; i < numBytes; i++)
+		value |= (unsigned long long) *reader.position++ << (8 * i);
+
+	return value;
+}
+
+static void readBoard(ByteReader &reader, Cell *board, int numCells, int bitsPerCell)
+{
+	unsigned int buffer;
+	int bufferedBits;
+
+	buffer = 0;
+	bufferedBits = 0;
+	for(int i = 0; i < numCells; i++)
+	{
+		while(bufferedBits < bitsPerCell)
+		{
+			buffer |= (unsigned int) readValue(reader, 1) << bufferedBits;
+			bufferedBits += 8;
+		}
+		board[i] = (Cell) (buffer & ((1u << bitsPerCell) - 1));
+		buffer >>= bitsPerCell;
+		bufferedBits -= bitsPerCell;
+	}
+}
+
+//Just enough bits for every value of a cell, 0 (empty) through sizeOfBoard
+static int bitsPerCellFor(int sizeOfBoard)
+{
+	int bits;
+
+	bits = 1;
+	while((1 << bits) <= sizeOfBoard)
+		bits++;
+
+	return bits;
+}
+
+static bool isBoardSize(int sizeOfBoard)
+{
+	return (sizeOfBoard == 4) || (sizeOfBoard == 9) || (sizeOfBoard == 16) || (sizeOfBoard == 25) || (sizeOfBoard == 36);
+}
+
+static void writeHeader(std::string &bytes, bool hasState, int sizeOfBoard, int numPuzzles)
+{
+	bytes.append(binaryFormatMagic, 4);
+	writeValue(bytes, binaryFormatVersion, 2);
+	writeValue(bytes, hasState ? 1 : 0, 1);
+	writeValue(bytes, sizeOfBoard, 1);
+	writeValue(bytes, bitsPerCellFor(sizeOfBoard), 1);
+	writeValue(bytes, numPuzzles, 4);
+}
+
+//Fills in the header fields, false if the data isn't a binary puzzle file this version can read
+//	Version 1 files only lack the operator selection (and the islands' operator statistics) of a checkpoint, version 2 files its breeding tasks
+static bool readHeader(ByteReader &reader, int &version, bool &hasState, int &sizeOfBoard, int &numPuzzles)
+{
+	int bitsPerCell;
+
+	for(int i = 0; i < 4; i++)
+		if(readValue(reader, 1) != (unsigned char) binaryFormatMagic[i])
+			return false;
+	version = (int) readValue(reader, 2);
+	hasState = (readValue(reader, 1) & 1) != 0;
+	sizeOfBoard = (int) readValue(reader, 1);
+	bitsPerCell = (int) readValue(reader, 1);
+	numPuzzles = (int) readValue(reader, 4);
+
+	return !reader.failed && (version >= 1) && (version <= binaryFormatVersion) && isBoardSize(sizeOfBoard) && (bitsPerCell == bitsPerCellFor(sizeOfBoard));
+}
+
+static bool writeFile(const char *fileName, const std::string &bytes)
+{
+	std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+
+	if(!file)
+		return false;
+	file.write(bytes.data(), bytes.size());
+
+	return !file.fail();
+}
+
+bool replaceFile(const char *fileName, const std::string &contents)
+{
+	std::string temporaryName;
+
+	temporaryName = std::string(fileName) + ".tmp";
+	if(!writeFile(temporaryName.c_str(), contents))
+		return false;
+
+#if defined(_WIN32)
+	return MoveFileExA(temporaryName.c_str(), fileName, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(temporaryName.c_str(), fileName) == 0;
+#endif
+}
+
+bool isBinaryPuzzleData(const char *begin, const char *end)
+{
+	return (end - begin >= 4) && (memcmp(begin, binaryFormatMagic, 4) == 0);
+}
+
+bool decodePuzzles(const char *begin, const char *end, std::vector<std::vector<int>> &puzzles)
+{
+	ByteReader reader;
+	std::vector<Cell> board;
+	bool hasState;
+	int version;
+	int sizeOfBoard;
+	int numPuzzles;
+
+	reader = makeReader(begin, end);
+	if(!readHeader(reader, version, hasState, sizeOfBoard, numPuzzles))
+		return false;
+
+	board.resize(sizeOfBoard * sizeOfBoard);
+	puzzles.reserve(puzzles.size() + numPuzzles);
+	for(int i = 0; (i < numPuzzles) && !reader.failed; i++)
+	{
+		readBoard(reader, board.data(), (int) board.size(), bitsPerCellFor(sizeOfBoard));
+		puzzles.push_back(std::vector<int>(board.begin(), board.end()));
+	}
+
+	return !reader.failed;
+}
+
+bool writePuzzles(const char *fileName, const std::vector<std::vector<int>> &puzzles)
+{
+	std::string bytes;
+	std::vector<Cell> board;
+	int sizeOfBoard;
+
+	sizeOfBoard = puzzles.empty() ? 9 : (int) (sqrt((double) puzzles[0].size()) + .5);
+	if(!isBoardSize(sizeOfBoard))
+		return false;
+
+	writeHeader(bytes, false, sizeOfBoard, (int) puzzles.size());
+	for(int i = 0; i < puzzles.size(); i++)
+	{
+		if(puzzles[i].size() != sizeOfBoard * sizeOfBoard)
+			return false;
+		board.assign(puzzles[i].begin(), puzzles[i].end());
+		writeBoard(bytes, board.data(), (int) board.size(), bitsPerCellFor(sizeOfBoard));
+	}
+
+	return writeFile(fileName, bytes);
+}
+
+bool writeCheckpoint(const char *fileName, const Checkpoint &checkpoint)
+{
+	std::string bytes;
+	unsigned long long varianceBits;
+	unsigned long long statisticBits;
+	int bitsPerCell;
+	int numCells;
+
+	bitsPerCell = bitsPerCellFor(checkpoint.sizeOfBoard);
+	numCells = checkpoint.sizeOfBoard * checkpoint.sizeOfBoard;
+
+	writeHeader(bytes, !checkpoint.islands.empty(), checkpoint.sizeOfBoard, 1);
+	writeBoard(bytes, checkpoint.givens.data(), numCells, bitsPerCell);
+
+	if(!checkpoint.islands.empty())
+	{
+		writeValue(bytes, checkpoint.seed, 8);
+		writeValue(bytes, checkpoint.populationSize, 4);
+		writeValue(bytes, checkpoint.numberOfGenerations, 4);
+		writeValue(bytes, checkpoint.numberOfMigrants, 4);
+		writeValue(bytes, checkpoint.randomPercent, 4);
+		writeValue(bytes, checkpoint.stagnationEpochs, 4);
+		writeValue(bytes, checkpoint.migrationTopology, 1);
+		writeValue(bytes, checkpoint.localSearch, 1);
+		writeValue(bytes, checkpoint.selection, 1);
+		writeValue(bytes, checkpoint.operatorSelection, 1);
+		writeValue(bytes, checkpoint.breedingTasks, 4);
+		writeValue(bytes, checkpoint.migrationRounds, 4);
+		writeValue(bytes, checkpoint.lastImprovement, 4);
+		writeValue(bytes, checkpoint.islands.size(), 4);
+
+		for(int i = 0; i < checkpoint.islands.size(); i++)
+		{
+			const IslandState &island = checkpoint.islands[i];
+
+			memcpy(&varianceBits, &island.variance, sizeof(varianceBits));
+			writeValue(bytes, island.generations, 4);
+			writeValue(bytes, varianceBits, 8);
+			for(int j = 0; j < 4; j++)
+				writeValue(bytes, island.randomState[j], 8);
+			for(int j = 0; j < checkpoint.populationSize; j++)
+				writeBoard(bytes, &island.boards[j * numCells], numCells, bitsPerCell);
+			for(int j = 0; j < checkpoint.populationSize; j++)
+				writeValue(bytes, island.fitness[j], 4);
+
+			writeValue(bytes, island.operatorStatistics.size(), 4);
+			for(int j = 0; j < island.operatorStatistics.size(); j++)
+			{
+				memcpy(&statisticBits, &island.operatorStatistics[j], sizeof(statisticBits));
+				writeValue(bytes, statisticBits, 8);
+			}
+		}
+	}
+
+	return replaceFile(fileName, bytes);
+}
+
+//Every cell of an island's board has to hold one of the numbers, the puzzle's givens have to be where the puzzle has them,
+//	and every macroBlock has to hold each number once, since the genetic operators only ever swap cells within a macroBlock
+static bool isValidIslandBoard(const Cell *board, const std::vector<Cell> &givens, int sizeOfBoard)
+{
+	int sizeOfMacroBlock;
+	unsigned long long blockNumbers;
+
+	for(int i = 0; i < givens.size(); i++)
+	{
+		if((board[i] < 1) || (board[i] > sizeOfBoard) || (givens[i] && (board[i] != givens[i])))
+			return false;
+	}
+
+	sizeOfMacroBlock = (int) (sqrt((double) sizeOfBoard) + .5);
+	for(int block = 0; block < sizeOfBoard; block++)
+	{
+		blockNumbers = 0;
+		for(int position = 0; position < sizeOfBoard; position++)
+			blockNumbers |= 1ULL << (board[convertCoordinates((block % sizeOfMacroBlock) * sizeOfMacroBlock + (position % sizeOfMacroBlock), (block / sizeOfMacroBlock) * sizeOfMacroBlock + (position / sizeOfMacroBlock), sizeOfBoard)] - 1);
+		if(blockNumbers != (~0ULL >> (64 - sizeOfBoard)))
+			return false;
+	}
+
+	return true;
+}
+
+//A file without run state (a plain binary puzzle file) reads in as a checkpoint without any islands
+//	Everything the islands would be rebuilt from is checked here, a resumed run trusts its checkpoint's boards and settings
+bool readCheckpoint(const char *fileName, Checkpoint &checkpoint)
+{
+	MappedFile file(fileName);
+	ByteReader reader;
+	unsigned long long varianceBits;
+	unsigned long long statisticBits;
+	bool hasState;
+	int version;
+	int numPuzzles;
+	int numIslands;
+	int numStatistics;
+	int bitsPerCell;
+	int numCells;
+
+	if(!file.isOpen())
+		return false;
+
+	reader = makeReader(file.begin(), file.end());
+	if(!readHeader(reader, version, hasState, checkpoint.sizeOfBoard, numPuzzles) || (numPuzzles != 1))
+		return false;
+
+	bitsPerCell = bitsPerCellFor(checkpoint.sizeOfBoard);
+	numCells = checkpoint.sizeOfBoard * checkpoint.sizeOfBoard;
+	checkpoint.givens.resize(numCells);
+	readBoard(reader, checkpoint.givens.data(), numCells, bitsPerCell);
+	checkpoint.islands.clear();
+	if(!hasState)
+		return !reader.failed;
+
+	checkpoint.seed = readValue(reader, 8);
+	checkpoint.populationSize = (int) readValue(reader, 4);
+	checkpoint.numberOfGenerations = (int) readValue(reader, 4);
+	checkpoint.numberOfMigrants = (int) readValue(reader, 4);
+	checkpoint.randomPercent = (int) readValue(reader, 4);
+	checkpoint.stagnationEpochs = (int) readValue(reader, 4);
+	checkpoint.migrationTopology = (int) readValue(reader, 1);
+	checkpoint.localSearch = (int) readValue(reader, 1);
+	checkpoint.selection = (int) readValue(reader, 1);
+	checkpoint.operatorSelection = (version >= 2) ? (int) readValue(reader, 1) : 0;
+	checkpoint.breedingTasks = (version >= 3) ? (int) readValue(reader, 4) : 1;
+	checkpoint.migrationRounds = (int) readValue(reader, 4);
+	checkpoint.lastImprovement = (int) readValue(reader, 4);
+	numIslands = (int) readValue(reader, 4);
+
+	//Sizes are checked against what's actually left before anything is allocated off of them
+	if(reader.failed || (checkpoint.populationSize <= 0) || (checkpoint.breedingTasks <= 0) || (checkpoint.breedingTasks > checkpoint.populationSize) || (numIslands <= 0) || ((long long) numIslands * checkpoint.populationSize * (numCells * bitsPerCell / 8 + 4) > (long long) file.size()))
+		return false;
+	//The same limits parseCommandLine puts on the settings, the run would otherwise pick up whatever the file says
+	if((checkpoint.populationSize < 10) || (checkpoint.numberOfGenerations <= 0) || (checkpoint.numberOfMigrants <= 0) || (checkpoint.numberOfMigrants > checkpoint.populationSize) || (checkpoint.randomPercent <= 0) || (checkpoint.stagnationEpochs < 0))
+		return false;
+	if((checkpoint.migrationTopology >= checkpointTopologies) || (checkpoint.localSearch >= checkpointLocalSearches) || (checkpoint.selection >= checkpointSelections) || (checkpoint.operatorSelection >= checkpointOperatorSelections))
+		return false;
+
+	checkpoint.islands.resize(numIslands);
+	for(int i = 0; (i < numIslands) && !reader.failed; i++)
+	{
+		IslandState &island = checkpoint.islands[i];
+
+		island.generations = (int) readValue(reader, 4);
+		varianceBits = readValue(reader, 8);
+		memcpy(&island.variance, &varianceBits, sizeof(varianceBits));
+		for(int j = 0; j < 4; j++)
+			island.randomState[j] = readValue(reader, 8);
+
+		island.boards.resize(checkpoint.populationSize * numCells);
+		island.fitness.resize(checkpoint.populationSize);
+		for(int j = 0; j < checkpoint.populationSize; j++)
+		{
+			readBoard(reader, &island.boards[j * numCells], numCells, bitsPerCell);
+			if(!isValidIslandBoard(&island.boards[j * numCells], checkpoint.givens, checkpoint.sizeOfBoard))
+				return false;
+		}
+		for(int j = 0; j < checkpoint.populationSize; j++)
+			island.fitness[j] = (int) readValue(reader, 4);
+
+		numStatistics = (version >= 2) ? (int) readValue(reader, 4) : 0;
+		if(reader.failed || (numStatistics < 0) || (numStatistics > reader.end - reader.position))
+			return false;
+		island.operatorStatistics.resize(numStatistics);
+		for(int j = 0; j < numStatistics; j++)
+		{
+			statisticBits = readValue(reader, 8);
+			memcpy(&island.operatorStatistics[j], &statisticBits, sizeof(statisticBits));
+		}
+	}
+
+	return !reader.failed;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <fstream>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Utils.h"
+
+//Every binary puzzle (or checkpoint) file starts with these 4 bytes, followed by the version
+#define binaryFormatMagic "GSDK"
+#define binaryFormatVersion 3
+//How many values each of a checkpoint's enum settings can take, anything else is rejected (SolverConfig.cpp checks these against the enums)
+#define checkpointTopologies 3
+#define checkpointLocalSearches 4
+#define checkpointSelections 4
+#define checkpointOperatorSelections 2
+
+//Everything an island needs to carry on exactly where it left off (see GeneticPopulation::saveState)
+struct IslandState
+{
+	int generations;						//Generations the island has run so far
+	double variance;
+	unsigned long long randomState[4];		//Its RandomGenerator, mid-sequence
+	std::vector<Cell> boards;				//Every genePool board, back to back in slot order
+	std::vector<int> fitness;				//The fitness of each of them
+	std::vector<double> operatorStatistics;	//What its OperatorBandits have learnt, empty unless they're in use
+};
+
+//A puzzle, plus (if there are any islands) a snapshot of a run on it
+//	The settings the islands' state depends on are saved along with it, so a resumed run is the same run
+//	The enums are kept as ints so this doesn't have to know about the rest of the solver, readCheckpoint only accepts valid ones
+struct Checkpoint
+{
+	int sizeOfBoard;
+	std::vector<Cell> givens;				//The puzzle's givens, including the ones constraint propagation added
+	unsigned long long seed;
+	int populationSize;
+	int numberOfGenerations;
+	int numberOfMigrants;
+	int randomPercent;
+	int stagnationEpochs;
+	int migrationTopology;
+	int localSearch;
+	int selection;
+	int operatorSelection;
+	int breedingTasks;						//The shares the children are bred in decide which random numbers each child gets
+	int migrationRounds;					//PopulationCongregator's counters, so stagnation is still measured from the same point
+	int lastImprovement;
+	std::vector<IslandState> islands;		//Empty if it's just the puzzle
+};
+
+//Layout (all little-endian): magic, u16 version, u8 flags (1 if there's run state), u8 sizeOfBoard, u8 bitsPerCell, u32 number
+//	of puzzles, then each puzzle's cells packed bitsPerCell bits apiece (5 for a 25x25) and padded out to a whole byte.
+//	A checkpoint holds a single puzzle followed by the run state, where every board is packed the same way (version 2 added the
+//	operator selection to the settings, and a u32 count of doubles of operator statistics to the end of each island, version 3
+//	a u32 number of breeding tasks right after the operator selection)
+bool isBinaryPuzzleData(const char *, const char *);					//Whether some data starts out like a binary puzzle file
+bool decodePuzzles(const char *, const char *, std::vector<std::vector<int>> &);	//Every puzzle in binary data (a checkpoint's puzzle included), false if it's malformed
+bool writePuzzles(const char *, const std::vector<std::vector<int>> &);	//Writes puzzles (all of the same size) as a binary puzzle file
+bool writeCheckpoint(const char *, const Checkpoint &);					//Written next to the file and then renamed over it, so a crash never leaves half a checkpoint
+bool readCheckpoint(const char *, Checkpoint &);
+bool replaceFile(const char *, const std::string &);					//Writes a whole file next to the old one and renames it over it, so readers never see half of it
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "BoardHashSet.h"
+
+//This lets you call BoardHashSet x;
+BoardHashSet::BoardHashSet()
+{
+	mask = 0;
+}
+
+//Kept at most half full, so probes stay short
+BoardHashSet::BoardHashSet(int maxHashes)
+{
+	int capacity;
+
+	capacity = 2;
+	while(capacity < 2 * maxHashes)
+		capacity *= 2;
+
+	hashes.assign(capacity, 0);
+	counts.assign(capacity, 0);
+	mask = capacity - 1;
+}
+
+size_t BoardHashSet::findSlot(unsigned long long hash) const
+{
+	size_t slot;
+
+	slot = (size_t) (hash & mask);
+	while((counts[slot] > 0) && (hashes[slot] != hash))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+void BoardHashSet::insert(unsigned long long hash)
+{
+	size_t slot;
+
+	slot = findSlot(hash);
+	hashes[slot] = hash;
+	counts[slot]++;
+}
+
+//Once a hash is gone, the entries after it are shifted back into the gap, so no probe sequence is ever cut short (no tombstones)
+void BoardHashSet::remove(unsigned long long hash)
+{
+	size_t gap;
+	size_t slot;
+	size_t home;
+
+	gap = findSlot(hash);
+	if((counts[gap] == 0) || (--counts[gap] > 0))
+		return;
+
+	for(slot = (gap + 1) & mask; counts[slot] > 0; slot = (slot + 1) & mask)
+	{
+		//An entry can only fill the gap if the gap lies between its home slot and where it ended up
+		home = (size_t) (hashes[slot] & mask);
+		if(((slot - home) & mask) < ((slot - gap) & mask))
+			continue;
+
+		hashes[gap] = hashes[slot];
+		counts[gap] = counts[slot];
+		counts[slot] = 0;
+		gap = slot;
+	}
+}
+
+bool BoardHashSet::contains(unsigned long long hash) const
+{
+	if(counts.empty())
+		return false;
+
+	return counts[findSlot(hash)] > 0;
+}
\ No newline at end of file
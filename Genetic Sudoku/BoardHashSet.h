@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//Counts how many boards of a pool have each Zobrist hash, so duplicates can be spotted without comparing boards
+//	Open addressing with linear probing, sized once up front: nothing is allocated while it's in use
+class BoardHashSet
+{
+private:
+	std::vector<unsigned long long> hashes;
+	std::vector<int> counts;				//How many boards have the hash in each slot, 0 if the slot is empty
+	unsigned long long mask;				//Number of slots - 1, the slots are a power of two
+
+	size_t findSlot(unsigned long long) const;	//Slot holding a hash, or the empty slot it would go in
+public:
+	BoardHashSet();
+	BoardHashSet(int);						//Creates a set for up to some number of distinct hashes
+
+	void insert(unsigned long long);
+	void remove(unsigned long long);		//Takes away one board with the hash, which has to be in the set
+	bool contains(unsigned long long) const;
+};
\ No newline at end of file
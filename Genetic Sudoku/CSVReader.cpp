@@ -1,34 +1,228 @@
 #include "CSVReader.h"
 
-std::vector<int> parseFile(char *fileName, char delim)
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+//Whether a number of cells makes up a whole board (n^2 x n^2, up to 36x36), rows never have more than 36 cells
+static bool isBoardLength(size_t numCells)
+{
+	return (numCells == 16) || (numCells == 81) || (numCells == 256) || (numCells == 625) || (numCells == 1296);
+}
+
+//The value of a cell in the one-character-per-cell format, -1 if it isn't one
+static int compactCellValue(char cell)
 {
-	int tempInt;
-	std::ifstream file;
-	std::vector<int> largeBuffer;
-	std::string lineBuffer;
-	std::regex pattern;
+	if((cell == '.') || (cell == '0'))
+		return 0;
+	if((cell >= '1') && (cell <= '9'))
+		return cell - '0';
+	if((cell >= 'A') && (cell <= 'Z'))
+		return cell - 'A' + 10;
+	if((cell >= 'a') && (cell <= 'z'))
+		return cell - 'a' + 10;
+
+	return -1;
+}
+
+//A line is a whole puzzle in the one-character-per-cell format if it's the right length and every character is a cell
+//	The characters run out at Z (35), so the format stops at 25x25, a 36x36 puzzle has to be written out as numbers
+static bool isCompactLine(const char *line, const char *lineEnd)
+{
+	if((lineEnd - line > 625) || !isBoardLength(lineEnd - line))
+		return false;
+
+	for(const char *i = line; i < lineEnd; i++)
+		if(compactCellValue(*i) < 0)
+			return false;
 
-	pattern = ("[0-9]+");	//Any amount of contiguous numerical characters
-	file = std::ifstream(fileName);
+	return true;
+}
 
-	if(!file)
+//Every puzzle that's finished goes in puzzles, a malformed one goes in empty
+static void finishPuzzle(std::vector<int> &current, bool &malformed, std::vector<std::vector<int>> &puzzles)
+{
+	if(!current.empty() || malformed)
 	{
-		std::cerr << "Could not open file." << std::endl;
-		return std::vector<int>();
+		puzzles.push_back(std::vector<int>());
+		if(!malformed)
+			puzzles.back().swap(current);
 	}
 
-	//There has to be a better way to do this...
-	while(file)
+	current.clear();
+	malformed = false;
+}
+
+void parsePuzzleText(const char *begin, const char *end, std::vector<std::vector<int>> &puzzles, char delim)
+{
+	std::vector<int> current;	//The puzzle being read
+	bool malformed;				//Whether the current puzzle had something in it that isn't part of any format
+	size_t rowLength;			//Cells in the first row of the current puzzle, the puzzle is done after that many rows
+	size_t lineStart;			//Cells the current puzzle had before this line
+	const char *line;
+	const char *lineEnd;
+	const char *next;
+	int value;
+	bool inNumber;
+
+	malformed = false;
+	rowLength = 0;
+
+	for(line = begin; line < end; line = next)
 	{
-		std::getline(file, lineBuffer);
-		const std::sregex_token_iterator end;
-		//Iterate through while trying to pattern match
-		for (std::sregex_token_iterator i(lineBuffer.cbegin(), lineBuffer.cend(), pattern); i != end; ++i)	
+		lineEnd = (const char *) memchr(line, '\n', end - line);
+		if(lineEnd == NULL)
+			lineEnd = end;
+		next = lineEnd + 1;
+		while((lineEnd > line) && ((lineEnd[-1] == '\r') || (lineEnd[-1] == ' ') || (lineEnd[-1] == '\t')))
+			lineEnd--;
+
+		if(isCompactLine(line, lineEnd))
 		{
-			std::stringstream(*i) >> tempInt;
-			largeBuffer.push_back(tempInt);
+			finishPuzzle(current, malformed, puzzles);
+			for(const char *i = line; i < lineEnd; i++)
+				current.push_back(compactCellValue(*i));
+			finishPuzzle(current, malformed, puzzles);
+			continue;
 		}
+
+		//Numbers are runs of digits, everything between them has to be a delimiter or a space
+		lineStart = current.size();
+		value = 0;
+		inNumber = false;
+		for(const char *i = line; i <= lineEnd; i++)
+		{
+			if((i < lineEnd) && (*i >= '0') && (*i <= '9'))
+			{
+				//Once a number is way out of range the rest of its digits are skipped, so a long run of them can't overflow
+				if(value <= 1000)
+					value = value * 10 + (*i - '0');
+				if(value > 1000)
+					malformed = true;
+				inNumber = true;
+				continue;
+			}
+
+			if(inNumber)
+				current.push_back(value);
+			value = 0;
+			inNumber = false;
+
+			if((i < lineEnd) && (*i != delim) && (*i != ' ') && (*i != '\t'))
+				malformed = true;
+		}
+
+		//A line without numbers ends the current puzzle
+		if(current.size() == lineStart)
+		{
+			if(lineEnd > line)
+				malformed = true;
+			finishPuzzle(current, malformed, puzzles);
+			rowLength = 0;
+			continue;
+		}
+
+		//A line holding a whole board is a puzzle on its own, whatever was being read before it is cut off there
+		if((current.size() - lineStart > 36) && isBoardLength(current.size() - lineStart))
+		{
+			if(lineStart > 0)
+			{
+				std::vector<int> wholeLine(current.begin() + lineStart, current.end());
+
+				current.resize(lineStart);
+				finishPuzzle(current, malformed, puzzles);
+				current.swap(wholeLine);
+			}
+			finishPuzzle(current, malformed, puzzles);
+			rowLength = 0;
+			continue;
+		}
+
+		if(rowLength == 0)
+			rowLength = current.size();
+		if(current.size() >= rowLength * rowLength)
+		{
+			finishPuzzle(current, malformed, puzzles);
+			rowLength = 0;
+		}
+	}
+
+	finishPuzzle(current, malformed, puzzles);
+}
+
+std::vector<int> parseFile(const char *fileName, char delim)
+{
+	std::vector<std::vector<int>> puzzles;
+
+	if(!parsePuzzleFile(fileName, puzzles, delim))
+	{
+		std::cerr << "Could not read file." << std::endl;
+		return std::vector<int>();
+	}
+	if(puzzles.empty())
+		return std::vector<int>();
+
+	return puzzles[0];
+}
+
+bool parsePuzzleFile(const char *fileName, std::vector<std::vector<int>> &puzzles, char delim)
+{
+	MappedFile file(fileName);
+
+	if(!file.isOpen())
+		return false;
+	if(isBinaryPuzzleData(file.begin(), file.end()))
+		return decodePuzzles(file.begin(), file.end(), puzzles);
+
+	parsePuzzleText(file.begin(), file.end(), puzzles, delim);
+	return true;
+}
+
+std::vector<std::vector<int>> parsePuzzleStream(std::istream &input, char delim)
+{
+	std::vector<std::vector<int>> puzzles;
+	std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	parsePuzzleText(text.data(), text.data() + text.size(), puzzles, delim);
+
+	return puzzles;
+}
+
+bool listDirectory(const char *path, std::vector<std::string> &fileNames)
+{
+#if defined(_WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle;
+
+	findHandle = FindFirstFileA((std::string(path) + "\\*").c_str(), &findData);
+	if(findHandle == INVALID_HANDLE_VALUE)
+		return false;
+	do
+	{
+		if(!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			fileNames.push_back(std::string(path) + "\\" + findData.cFileName);
+	} while(FindNextFileA(findHandle, &findData));
+	FindClose(findHandle);
+#else
+	DIR *directory;
+	dirent *entry;
+	struct stat fileStatus;
+
+	directory = opendir(path);
+	if(directory == NULL)
+		return false;
+	while((entry = readdir(directory)) != NULL)
+	{
+		std::string fileName = std::string(path) + "/" + entry->d_name;
+		if((stat(fileName.c_str(), &fileStatus) == 0) && S_ISREG(fileStatus.st_mode))
+			fileNames.push_back(fileName);
 	}
+	closedir(directory);
+#endif
 
-	return largeBuffer;
+	std::sort(fileNames.begin(), fileNames.end());
+	return true;
 }
\ No newline at end of file
@@ -1,15 +1,35 @@
 #pragma once
 
 #include <fstream>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <iterator>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
 #include <vector>
-#include <regex>
 #include <assert.h>
+#include "BinaryFormat.h"
+#include "MappedFile.h"
 
 //Returns a vector of ints that represents a Sudoku Puzzle, 0 represents empty space
-//	Only parses properly formatted (CRLF-line ended, comma-delineated text files) file representation of Sudoku
-std::vector<int> parseFile(char *fileName, char delim = ',');
\ No newline at end of file
+//	Reads the first puzzle out of a file in any of the formats parsePuzzleFile understands, empty if there isn't one
+std::vector<int> parseFile(const char *fileName, char delim = ',');
+
+//Reads any number of Sudoku Puzzles out of text, in any mix of these formats (lines can end in LF or CRLF):
+//	- one row per line, the numbers separated by delim (or spaces), a puzzle ends after its last row or at a line without numbers
+//	- one puzzle per line, every cell in a single delim-separated list
+//	- one puzzle per line, one character per cell (16, 81, 256 or 625 of them, 36x36 doesn't fit): 1-9, then A (or a) for 10 onwards, 0 or . for empty
+//	A puzzle with anything else in it comes back empty, so it's still counted but can never pass PuzzleDefinition::isValidShape
+//	The text is only walked once, nothing is copied out of it other than the numbers themselves
+void parsePuzzleText(const char *begin, const char *end, std::vector<std::vector<int>> &puzzles, char delim = ',');
+
+//Same as parsePuzzleText, over a memory-mapped file, false if the file couldn't be read
+//	Binary puzzle files (and checkpoints) are recognized by their magic number and decoded instead (see BinaryFormat.h)
+bool parsePuzzleFile(const char *fileName, std::vector<std::vector<int>> &puzzles, char delim = ',');
+
+//Same as parsePuzzleText, over everything left in a stream (stdin, for instance, which can't be mapped)
+std::vector<std::vector<int>> parsePuzzleStream(std::istream &input, char delim = ',');
+
+//Fills in the paths of every regular file in a directory (not recursively), sorted by name, false if it isn't a directory
+bool listDirectory(const char *path, std::vector<std::string> &fileNames);
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "CheckpointWriter.h"
+
+CheckpointWriter::CheckpointWriter(const std::string &checkpointFile)
+{
+	fileName = checkpointFile;
+	hasPending = false;
+	stopping = false;
+	numWritten = 0;
+	writerThread = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(writerMutex);
+		stopping = true;
+	}
+	wakeUp.notify_one();
+	writerThread.join();
+}
+
+void CheckpointWriter::submit(const Checkpoint &checkpoint)
+{
+	{
+		std::lock_guard<std::mutex> lock(writerMutex);
+		pending = checkpoint;
+		hasPending = true;
+	}
+	wakeUp.notify_one();
+}
+
+int CheckpointWriter::getNumWritten()
+{
+	std::lock_guard<std::mutex> lock(writerMutex);
+
+	return numWritten;
+}
+
+//The checkpoint is taken out from under the lock before it's packed and written, so submit never waits on the disk
+void CheckpointWriter::writerLoop()
+{
+	Checkpoint writing;
+	bool written;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(writerMutex);
+			wakeUp.wait(lock, [this] { return hasPending || stopping; });
+			if(!hasPending)
+				return;
+
+			writing = pending;
+			hasPending = false;
+		}
+
+		written = writeCheckpoint(fileName.c_str(), writing);
+		if(!written)
+			std::cerr << "Could not write checkpoint: " << fileName << std::endl;
+
+		std::lock_guard<std::mutex> lock(writerMutex);
+		if(written)
+			numWritten++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "BinaryFormat.h"
+
+//Writes checkpoints to disk on its own thread, so the islands only ever pay for copying their genePools
+//	Only the latest checkpoint matters: one that comes in while an older one is still waiting to be written replaces it
+class CheckpointWriter
+{
+private:
+	std::string fileName;
+	std::thread writerThread;
+	std::mutex writerMutex;
+	std::condition_variable wakeUp;
+	Checkpoint pending;					//The next checkpoint to write
+	bool hasPending;
+	bool stopping;
+	int numWritten;
+
+	void writerLoop();
+public:
+	CheckpointWriter(const std::string &);	//Checkpoints go to (and keep replacing) this file
+	~CheckpointWriter();					//Writes whatever is still pending before returning
+
+	void submit(const Checkpoint &);		//Hands a checkpoint over to be written, returns right away
+	int getNumWritten();
+};
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "ExactSolver.h"
+
+//Every so many nodes the search checks whether it should stop
+#define stopCheckInterval 4096
+
+ExactSolver::ExactSolver(PuzzleDefinitionPtr puzzle)
+{
+	definition = puzzle;
+	sizeOfBoard = definition->getSizeOfBoard();
+	nodes = 0;
+	aborted = false;
+}
+
+unsigned long long ExactSolver::candidatesOf(int index)
+{
+	return definition->getCandidates(index) & ~(rowUsed[definition->getRow(index)] | colUsed[definition->getCol(index)] | blockUsed[definition->getBlock(index)]);
+}
+
+bool ExactSolver::canPlace(int index, int number)
+{
+	return (candidatesOf(index) & (1ULL << (number - 1))) != 0;
+}
+
+void ExactSolver::placeNumber(int index, int number)
+{
+	unsigned long long numberMask;
+
+	numberMask = 1ULL << (number - 1);
+	rowUsed[definition->getRow(index)] |= numberMask;
+	colUsed[definition->getCol(index)] |= numberMask;
+	blockUsed[definition->getBlock(index)] |= numberMask;
+	board[index] = number;
+}
+
+void ExactSolver::removeNumber(int index)
+{
+	unsigned long long numberMask;
+
+	numberMask = ~(1ULL << (board[index] - 1));
+	rowUsed[definition->getRow(index)] &= numberMask;
+	colUsed[definition->getCol(index)] &= numberMask;
+	blockUsed[definition->getBlock(index)] &= numberMask;
+	board[index] = 0;
+}
+
+//Looks through every row, column and macroBlock for a number that only fits in one cell of it
+//	Returns 1 and sets (index, options) to that cell and number if there is one, -1 if some number doesn't fit anywhere in a unit, 0 otherwise
+int ExactSolver::findHiddenSingle(int &index, unsigned long long &options)
+{
+	unsigned long long seenOnce;
+	unsigned long long seenTwice;
+	unsigned long long missing;
+	unsigned long long hidden;
+	unsigned long long cellCandidates;
+	int cell;
+
+	for(int unit = 0; unit < 3 * sizeOfBoard; unit++)
+	{
+		seenOnce = 0;
+		seenTwice = 0;
+		for(int position = 0; position < sizeOfBoard; position++)
+		{
+			cell = unitCell(unit, position);
+			if(board[cell] != 0)
+				continue;
+			cellCandidates = candidatesOf(cell);
+			seenTwice |= seenOnce & cellCandidates;
+			seenOnce |= cellCandidates;
+		}
+
+		missing = ((1ULL << sizeOfBoard) - 1) & ~unitUsed(unit);
+		if(missing & ~seenOnce)
+			return -1;
+
+		hidden = missing & seenOnce & ~seenTwice;
+		if(hidden != 0)
+		{
+			hidden &= ~hidden + 1;	//Just the lowest one
+			for(int position = 0; position < sizeOfBoard; position++)
+			{
+				cell = unitCell(unit, position);
+				if((board[cell] == 0) && (candidatesOf(cell) & hidden))
+				{
+					index = cell;
+					options = hidden;
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+//Rows, then columns, then macroBlocks
+int ExactSolver::unitCell(int unit, int position)
+{
+	if(unit < sizeOfBoard)
+		return convertCoordinates(position, unit, sizeOfBoard);
+	if(unit < 2 * sizeOfBoard)
+		return convertCoordinates(unit - sizeOfBoard, position, sizeOfBoard);
+	return definition->getCellIndex(unit - 2 * sizeOfBoard, position);
+}
+
+unsigned long long ExactSolver::unitUsed(int unit)
+{
+	if(unit < sizeOfBoard)
+		return rowUsed[unit];
+	if(unit < 2 * sizeOfBoard)
+		return colUsed[unit - sizeOfBoard];
+	return blockUsed[unit - 2 * sizeOfBoard];
+}
+
+//The cell that gets branched on is swapped to the end of the prefix, so the cells deeper in the search never move it
+bool ExactSolver::search(int numEmpty)
+{
+	unsigned long long options;
+	unsigned long long remaining;
+	int best;
+	int bestCount;
+	int count;
+	int index;
+
+	if(numEmpty == 0)
+		return true;
+
+	if((++nodes % stopCheckInterval == 0) && shouldStop && shouldStop())
+		aborted = true;
+	if((nodeLimit >= 0) && (nodes > nodeLimit))
+		aborted = true;
+	if(aborted)
+		return false;
+
+	//Minimum remaining values: a cell with no options fails right away, one with a single option costs nothing to branch on
+	best = 0;
+	bestCount = sizeOfBoard + 1;
+	options = 0;
+	for(int i = 0; i < numEmpty; i++)
+	{
+		remaining = candidatesOf(emptyCells[i]);
+		count = countBits(remaining);
+		if(count < bestCount)
+		{
+			best = i;
+			bestCount = count;
+			options = remaining;
+			if(count <= 1)
+				break;
+		}
+	}
+	if(bestCount == 0)
+		return false;
+
+	//Hidden singles: a number with only one place left in some unit is forced, and one with no place left is a dead end
+	if(bestCount > 1)
+	{
+		switch(findHiddenSingle(index, options))
+		{
+			case -1:
+				return false;
+			case 1:
+				for(int i = 0; i < numEmpty; i++)
+					if(emptyCells[i] == index)
+						best = i;
+				break;
+			default:
+				break;
+		}
+	}
+
+	std::swap(emptyCells[best], emptyCells[numEmpty - 1]);
+	index = emptyCells[numEmpty - 1];
+
+	for(remaining = options; remaining != 0; remaining &= remaining - 1)
+	{
+		placeNumber(index, countBits((remaining & (~remaining + 1)) - 1) + 1);	//Lowest set bit
+		if(search(numEmpty - 1))
+			return true;
+		removeNumber(index);
+
+		if(aborted)
+			return false;
+	}
+
+	return false;
+}
+
+//Cells of the partial board that don't fit (they clash with the givens or with each other) are just left empty
+bool ExactSolver::solve(const std::vector<Cell> &partialBoard, long long maxNodes, std::function<bool()> stopCheck)
+{
+	const std::vector<Cell> &givens = definition->getGivens();
+
+	nodes = 0;
+	nodeLimit = maxNodes;
+	shouldStop = stopCheck;
+	aborted = false;
+	board.assign(sizeOfBoard * sizeOfBoard, 0);
+	rowUsed.assign(sizeOfBoard, 0);
+	colUsed.assign(sizeOfBoard, 0);
+	blockUsed.assign(sizeOfBoard, 0);
+	emptyCells.clear();
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		if(givens[i] == 0)
+			continue;
+		if(!canPlace(i, givens[i]))
+			return false;
+		placeNumber(i, givens[i]);
+	}
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		if(givens[i] != 0)
+			continue;
+		if((partialBoard[i] != 0) && canPlace(i, partialBoard[i]))
+			placeNumber(i, partialBoard[i]);
+		else
+			emptyCells.push_back(i);
+	}
+
+	return search((int) emptyCells.size());
+}
+
+bool ExactSolver::wasAborted()
+{
+	return aborted;
+}
+
+long long ExactSolver::getNodes()
+{
+	return nodes;
+}
+
+const std::vector<Cell> &ExactSolver::getSolution()
+{
+	return board;
+}
+
+//Macroblocks of a board from the genetic search never conflict, so only rows and columns are checked
+std::vector<Cell> ExactSolver::keepConsistentCells(const std::vector<Cell> &fullBoard)
+{
+	std::vector<Cell> rowCounts(sizeOfBoard * sizeOfBoard, 0);
+	std::vector<Cell> colCounts(sizeOfBoard * sizeOfBoard, 0);
+	std::vector<Cell> partialBoard(fullBoard);
+	int number;
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		number = fullBoard[i] - 1;
+		rowCounts[convertCoordinates(number, definition->getRow(i), sizeOfBoard)]++;
+		colCounts[convertCoordinates(number, definition->getCol(i), sizeOfBoard)]++;
+	}
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		number = fullBoard[i] - 1;
+		if((rowCounts[convertCoordinates(number, definition->getRow(i), sizeOfBoard)] > 1) || (colCounts[convertCoordinates(number, definition->getCol(i), sizeOfBoard)] > 1))
+			partialBoard[i] = 0;
+	}
+
+	return partialBoard;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "PuzzleDefinition.h"
+
+//Exact Sudoku solver: depth-first backtracking over bitmasks of the numbers used in each row, column and macroBlock,
+//	always branching on the empty cell with the fewest candidates left (minimum remaining values), or on a number that only
+//	has one place left in some row, column or macroBlock (a hidden single)
+//	Used to finish off a genetic search that has stalled, it can start from a partially filled in board
+class ExactSolver
+{
+private:
+	PuzzleDefinitionPtr definition;
+	int sizeOfBoard;
+	std::vector<Cell> board;					//The board being filled in, 0 for empty
+	std::vector<unsigned long long> rowUsed;	//For each row, bit (number - 1) is set if number is in it
+	std::vector<unsigned long long> colUsed;
+	std::vector<unsigned long long> blockUsed;
+	std::vector<int> emptyCells;				//Board indices still to be filled in, the search only ever works on a prefix of these
+	long long nodes;							//Search nodes visited so far
+	long long nodeLimit;						//Gives up after this many nodes (-1 for no limit)
+	std::function<bool()> shouldStop;			//Polled every so often, the search gives up as soon as it returns true
+	bool aborted;								//Whether the last solve gave up rather than finishing
+
+	unsigned long long candidatesOf(int);		//Numbers that can still go in the cell at some board index
+	bool canPlace(int, int);
+	void placeNumber(int, int);
+	void removeNumber(int);
+	int findHiddenSingle(int &, unsigned long long &);	//Finds a (cell, number) that is forced because it's the number's only place in some unit
+	int unitCell(int, int);						//Board index of a position within a unit (rows, then columns, then macroBlocks)
+	unsigned long long unitUsed(int);			//Numbers already placed in a unit
+	bool search(int);							//Fills in the first n emptyCells, false if they can't be
+public:
+	ExactSolver(PuzzleDefinitionPtr);
+
+	bool solve(const std::vector<Cell> &, long long = -1, std::function<bool()> = std::function<bool()>());	//Completes a partial board (0 for empty), false if it can't be done or the search gave up
+	bool wasAborted();							//Whether the last solve ran out of nodes or was stopped, as opposed to proving there's no solution
+	long long getNodes();
+	const std::vector<Cell> &getSolution();		//The completed board after a successful solve
+	std::vector<Cell> keepConsistentCells(const std::vector<Cell> &);	//Clears every cell of a full board that conflicts with another in its row or column
+};
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "FitnessCache.h"
+
+//This lets you call FitnessCache x;
+FitnessCache::FitnessCache()
+{
+	mask = 0;
+}
+
+FitnessCache::FitnessCache(int numSlots)
+{
+	int capacity;
+
+	capacity = 1;
+	while(capacity < numSlots)
+		capacity *= 2;
+
+	hashes.assign(capacity, 0);
+	fitnesses.assign(capacity, -1);
+	mask = capacity - 1;
+}
+
+//The low bits of a Zobrist hash are as random as any others, so they pick the slot as is
+bool FitnessCache::lookup(unsigned long long hash, int &fitness)
+{
+	size_t slot;
+
+	if(hashes.empty())
+		return false;
+
+	slot = (size_t) (hash & mask);
+	if((fitnesses[slot] < 0) || (hashes[slot] != hash))
+		return false;
+
+	fitness = fitnesses[slot];
+	return true;
+}
+
+void FitnessCache::insert(unsigned long long hash, int fitness)
+{
+	size_t slot;
+
+	if(hashes.empty())
+		return;
+
+	slot = (size_t) (hash & mask);
+	hashes[slot] = hash;
+	fitnesses[slot] = fitness;
+}
\ No newline at end of file
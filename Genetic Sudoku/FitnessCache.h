@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//Bounded memo of fitnesses, keyed by a board's Zobrist hash (see PuzzleDefinition::hashBoard)
+//	Direct-mapped: every hash has exactly one slot, and a newer board simply evicts whatever was there, so lookups and
+//	inserts are a single probe and the cache never grows past the size it was created with
+//	Two different boards sharing a 64-bit hash is unlikely enough to be ignored
+class FitnessCache
+{
+private:
+	std::vector<unsigned long long> hashes;	//Hash of the board cached in each slot
+	std::vector<int> fitnesses;				//Its fitness, -1 if the slot is empty
+	unsigned long long mask;				//Number of slots - 1, the slots are a power of two
+public:
+	FitnessCache();
+	FitnessCache(int);						//Creates a cache with (at least) some number of slots
+
+	bool lookup(unsigned long long, int &);	//Fills in the fitness of a hash, false if it isn't cached
+	void insert(unsigned long long, int);
+};
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "FitnessKernels.h"
+
+//The vectorized kernels are only built for x86, everything else gets the scalar ones
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define FITNESS_KERNELS_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+//GCC and Clang only emit AVX2 instructions in functions that ask for them, which keeps the rest of the program runnable on older CPUs
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+//fixedSize is the board size a kernel is compiled for, or 0 for the kernel that works off of the runtime size
+//	Knowing the size at compile time lets the compiler unroll the loops and turn the index math into constants
+template<int fixedSize>
+static int countConflicts(const Cell *board, Cell *rowCounts, Cell *colCounts, int runtimeSize)
+{
+	const int size = (fixedSize > 0) ? fixedSize : runtimeSize;
+	int fitness;
+	int value;
+
+	memset(rowCounts, 0, size * size);
+	memset(colCounts, 0, size * size);
+	fitness = 0;
+
+	for(int i = 0; i < size; i++)
+	{
+		for(int j = 0; j < size; j++)
+		{
+			value = board[convertCoordinates(j, i, size)] - 1;
+
+			//Every occurence of a number past the first one in a row or column is a conflict
+			if(rowCounts[convertCoordinates(value, i, size)]++ > 0)
+				fitness++;
+			if(colCounts[convertCoordinates(value, j, size)]++ > 0)
+				fitness++;
+		}
+	}
+
+	return fitness;
+}
+
+//Scalar bitmask kernel, 64 bit masks so it handles every board size up to 64x64
+template<int fixedSize>
+static int scoreBoard(const Cell *board, int runtimeSize)
+{
+	const int size = (fixedSize > 0) ? fixedSize : runtimeSize;
+	unsigned long long colMasks[64];
+	unsigned long long rowMask;
+	unsigned long long bit;
+	int distinct;
+
+	memset(colMasks, 0, sizeof(colMasks));
+	distinct = 0;
+
+	for(int i = 0; i < size; i++)
+	{
+		rowMask = 0;
+		for(int j = 0; j < size; j++)
+		{
+			bit = 1ULL << (board[convertCoordinates(j, i, size)] - 1);
+			rowMask |= bit;
+			colMasks[j] |= bit;
+		}
+		distinct += countBits(rowMask);
+	}
+
+	for(int j = 0; j < size; j++)
+		distinct += countBits(colMasks[j]);
+
+	//Each of the 2 * size lines holds size cells, everything that isn't distinct is a conflict
+	return 2 * size * size - distinct;
+}
+
+#ifdef FITNESS_KERNELS_AVX2
+
+//Sums the set bits of all eight 32 bit lanes, using the nibble lookup table trick since AVX2 has no vector popcount
+TARGET_AVX2 static int countBits256(__m256i value)
+{
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+	__m256i counts;
+	unsigned long long sums[4];
+
+	counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(value, lowNibbles)), _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibbles)));
+	_mm256_storeu_si256((__m256i *) sums, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+
+	return (int) (sums[0] + sums[1] + sums[2] + sums[3]);
+}
+
+//AVX2 bitmask kernel, 32 bit masks so it only handles boards up to 32x32
+//	Eight columns are processed at a time: their cells are widened to 32 bit lanes and turned into 1 << (number - 1) with a variable shift,
+//	which gets OR'd into the column masks and (after a horizontal OR) into the row mask. Leftover columns are done one at a time.
+template<int fixedSize>
+TARGET_AVX2 static int scoreBoardAvx2(const Cell *board, int runtimeSize)
+{
+	const int size = (fixedSize > 0) ? fixedSize : runtimeSize;
+	const int numChunks = size / 8;
+	const __m256i ones = _mm256_set1_epi32(1);
+	__m256i colMasks[4];
+	unsigned int tailColMasks[8];
+	__m256i rowBits;
+	__m256i bits;
+	__m128i rowHalves;
+	unsigned int rowMask;
+	unsigned int bit;
+	const Cell *row;
+	int distinct;
+
+	for(int c = 0; c < numChunks; c++)
+		colMasks[c] = _mm256_setzero_si256();
+	memset(tailColMasks, 0, sizeof(tailColMasks));
+	distinct = 0;
+
+	for(int i = 0; i < size; i++)
+	{
+		row = board + convertCoordinates(0, i, size);
+		rowBits = _mm256_setzero_si256();
+		rowMask = 0;
+
+		for(int c = 0; c < numChunks; c++)
+		{
+			bits = _mm256_sllv_epi32(ones, _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (row + c * 8))), ones));
+			colMasks[c] = _mm256_or_si256(colMasks[c], bits);
+			rowBits = _mm256_or_si256(rowBits, bits);
+		}
+
+		for(int j = numChunks * 8; j < size; j++)
+		{
+			bit = 1U << (row[j] - 1);
+			tailColMasks[j - numChunks * 8] |= bit;
+			rowMask |= bit;
+		}
+
+		//Horizontal OR of the eight lanes
+		rowHalves = _mm_or_si128(_mm256_castsi256_si128(rowBits), _mm256_extracti128_si256(rowBits, 1));
+		rowHalves = _mm_or_si128(rowHalves, _mm_shuffle_epi32(rowHalves, _MM_SHUFFLE(1, 0, 3, 2)));
+		rowHalves = _mm_or_si128(rowHalves, _mm_shuffle_epi32(rowHalves, _MM_SHUFFLE(2, 3, 0, 1)));
+		rowMask |= (unsigned int) _mm_cvtsi128_si32(rowHalves);
+
+		distinct += _mm_popcnt_u32(rowMask);
+	}
+
+	for(int c = 0; c < numChunks; c++)
+		distinct += countBits256(colMasks[c]);
+	for(int j = numChunks * 8; j < size; j++)
+		distinct += _mm_popcnt_u32(tailColMasks[j - numChunks * 8]);
+
+	return 2 * size * size - distinct;
+}
+
+//Checks the CPU for AVX2 and POPCNT, and the OS for saving the AVX registers on context switches
+static bool detectAvx2()
+{
+#if defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if(info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	if(!(info[2] & (1 << 23)) || !(info[2] & (1 << 27)) || !(info[2] & (1 << 28)))	//POPCNT, OSXSAVE, AVX
+		return false;
+	if((_xgetbv(0) & 6) != 6)	//XMM and YMM state
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;	//AVX2
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+}
+
+bool hasAvx2Kernels()
+{
+	static const bool supported = detectAvx2();
+
+	return supported;
+}
+
+#else
+
+bool hasAvx2Kernels()
+{
+	return false;
+}
+
+#endif
+
+CountConflictsKernel selectCountConflictsKernel(int sizeOfBoard)
+{
+	switch(sizeOfBoard)
+	{
+	case 9:
+		return countConflicts<9>;
+	case 16:
+		return countConflicts<16>;
+	case 25:
+		return countConflicts<25>;
+	case 36:
+		return countConflicts<36>;
+	default:
+		return countConflicts<0>;
+	}
+}
+
+ScoreBoardKernel selectScoreBoardKernel(int sizeOfBoard)
+{
+#ifdef FITNESS_KERNELS_AVX2
+	if(hasAvx2Kernels() && (sizeOfBoard <= 32))
+	{
+		switch(sizeOfBoard)
+		{
+		case 9:
+			return scoreBoardAvx2<9>;
+		case 16:
+			return scoreBoardAvx2<16>;
+		case 25:
+			return scoreBoardAvx2<25>;
+		default:
+			return scoreBoardAvx2<0>;
+		}
+	}
+#endif
+
+	switch(sizeOfBoard)
+	{
+	case 9:
+		return scoreBoard<9>;
+	case 16:
+		return scoreBoard<16>;
+	case 25:
+		return scoreBoard<25>;
+	case 36:
+		return scoreBoard<36>;
+	default:
+		return scoreBoard<0>;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string.h>
+#include "Utils.h"
+
+//Full fitness evaluation: fills in the per-row and per-column number counts of a board and returns its number of conflicts
+//	Arguments are (board, rowCounts, colCounts, sizeOfBoard), with the counts laid out as in SudokuPuzzle
+typedef int (*CountConflictsKernel)(const Cell *, Cell *, Cell *, int);
+
+//Fitness-only evaluation: returns the number of conflicts of a (board, sizeOfBoard) without building any counts
+//	Every row and column is turned into a bitmask of the numbers in it, and its conflicts are sizeOfBoard - popcount(mask)
+typedef int (*ScoreBoardKernel)(const Cell *, int);
+
+CountConflictsKernel selectCountConflictsKernel(int);	//Picks the kernel specialized for a board size, or the generic one if there isn't any
+ScoreBoardKernel selectScoreBoardKernel(int);			//Same as above, but also picks the AVX2 version when the CPU supports it
+bool hasAvx2Kernels();									//Whether the CPU (and OS) support the AVX2 scoring kernels
\ No newline at end of file
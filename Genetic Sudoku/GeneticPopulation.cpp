@@ -1,228 +1,644 @@
 #include "GeneticPopulation.h"
 
 //Creates a population out of a pre-existing number of SudokuPuzzle configurations
-GeneticPopulation::GeneticPopulation(std::vector<SudokuPuzzle> initialConfig)
+GeneticPopulation::GeneticPopulation(std::vector<SudokuPuzzle> initialConfig, const SolverConfig &config, unsigned long long seed)
 {
-	//Called so vectors don't have to resize
-	genePool.reserve(populationSize);
-	childPool.reserve(populationSize);
-
 	//Initialization
-	genePool = initialConfig;
-	staticBoard = genePool[0].getStaticBoard();
-	optimalSolution = false;
-	sizeOfBoard = genePool[0].getSizeOfBoard();
-	sizeOfMacroBlock = genePool[0].getSizeOfMacroBlock();
+	random.seed(seed);
+	initialize(initialConfig[0], config);
 
+	for(int i = 0; i < initialConfig.size(); i++)
+		genePool.storeBoard(i, initialConfig[i].getBoard().data());
 
-	spawnAdditionalMembers();	//Fill up the genePool
+	spawnAdditionalMembers((int) initialConfig.size());	//Fill up the genePool
 	resetVariance();			//Initialize variance
-	advancePopulation();		//Advance the population
+	checkOptimality();
+}
+
+//Picks a population back up from a checkpoint, exactly as it was saved
+//	Everything else a population holds (the childPool, workspaces, cache) is either rebuilt every generation or only saves time
+GeneticPopulation::GeneticPopulation(const IslandState &state, PuzzleDefinitionPtr puzzle, const SolverConfig &config)
+{
+	initialize(SudokuPuzzle(puzzle, state.boards.data()), config);
+	random.setState(state.randomState);
+	variance = state.variance;
+	generations = state.generations;
+	if(state.operatorStatistics.size() == 3 * (numParentConfigurations + numPostMateMutations))
+	{
+		parentBandit.loadState(state.operatorStatistics.data());
+		mutationBandit.loadState(state.operatorStatistics.data() + 3 * numParentConfigurations);
+	}
+
+	for(int i = 0; i < populationSize; i++)
+		genePool.storeBoard(i, &state.boards[i * sizeOfBoard * sizeOfBoard]);
+
+	//The saved fitnesses aren't trusted, rescoring the boards gives the same ones for any checkpoint this program wrote
+	//	The ordering only ever depends on the fitnesses, so this puts it back the way it was
+	genePool.evaluateAll();
+	orderGenePool();
+	checkOptimality();
 }
 
-//Fills up the genePool with randomly generated configurations
-void GeneticPopulation::spawnAdditionalMembers()
+//Breeding tasks left over from the last generation still point at this population
+GeneticPopulation::~GeneticPopulation()
 {
-	while(genePool.size() < populationSize)
-		genePool.push_back(SudokuPuzzle(staticBoard));
+	std::unique_lock<std::mutex> lock(breedingMutex);
+	breedingDone.wait(lock, [this] { return queuedBreedingTasks == 0; });
+}
+
+//Settings and storage shared by both constructors, the genePool is left empty
+void GeneticPopulation::initialize(SudokuPuzzle initialPuzzle, const SolverConfig &config)
+{
+	populationSize = config.populationSize;
+	numberOfGenerations = config.numberOfGenerations;
+	randomPercent = config.randomPercent;
+	localSearchOperator = config.localSearch;
+	selection = config.selection;
+	operatorSelection = config.operatorSelection;
+	minimumImprovement = populationSize * .2;
+	definition = initialPuzzle.getDefinition();
+	optimalSolution = false;
+	generations = 0;
+	sizeOfBoard = initialPuzzle.getSizeOfBoard();
+	sizeOfMacroBlock = initialPuzzle.getSizeOfMacroBlock();
+	eliteCount = std::max(1, populationSize / 10);
+
+	//Linear ranking: rank 0 gets rankSelectionPressure times the average chance, the last rank gets 2 - rankSelectionPressure times
+	if(selection == rankWeightedSelection)
+	{
+		double cumulative;
+
+		cumulative = 0;
+		rankCdf.resize(populationSize);
+		for(int i = 0; i < populationSize; i++)
+		{
+			cumulative += (rankSelectionPressure - (2 * rankSelectionPressure - 2) * i / (double) (populationSize - 1)) / populationSize;
+			rankCdf[i] = cumulative;
+		}
+	}
+
+	//Both pools are allocated once here, out of one arena, so they never have to resize and can trade boards instead of copying them
+	boardArena = std::make_shared<BoardArena>(sizeOfBoard * sizeOfBoard, 2 * populationSize);
+	genePool = SpecimenPool(definition, populationSize, boardArena);
+	childPool = SpecimenPool(definition, populationSize, boardArena);
+	scheduler = NULL;
+	queuedBreedingTasks = 0;
+	nextShare = config.breedingTasks;	//Nothing to claim until the first generation
+	sharesBred = 0;
+	breeders.resize(config.breedingTasks);
+	for(int b = 0; b < breeders.size(); b++)
+	{
+		Breeder &breeder = breeders[b];
+
+		breeder.childWorkspace = initialPuzzle;
+		breeder.parentWorkspace = initialPuzzle;
+		breeder.randomParents.resize(2, initialPuzzle);
+		breeder.fitnessCache = FitnessCache(fitnessCacheSize);
+		breeder.randomDraws.resize(sizeOfBoard * sizeOfBoard);
+		breeder.localSearch = LocalSearch(sizeOfBoard);
+		breeder.random = (breeders.size() == 1) ? &random : &breeder.stream;
+		breeder.firstChild = b * populationSize / (int) breeders.size();
+		breeder.lastChild = (b + 1) * populationSize / (int) breeders.size();
+		breeder.stopped = false;
+
+		//Every evaluation the workspaces make is counted, copying one workspace into another keeps it pointing here
+		clearMetrics(breeder.metrics);
+		breeder.evaluations = 0;
+		breeder.polledEvaluations = 0;
+		breeder.childWorkspace.setFitnessCache(&breeder.fitnessCache);
+		breeder.parentWorkspace.setFitnessCache(&breeder.fitnessCache);
+		breeder.childWorkspace.setEvaluationCounter(&breeder.evaluations);
+		breeder.parentWorkspace.setEvaluationCounter(&breeder.evaluations);
+		for(int i = 0; i < breeder.randomParents.size(); i++)
+		{
+			breeder.randomParents[i].setFitnessCache(&breeder.fitnessCache);
+			breeder.randomParents[i].setEvaluationCounter(&breeder.evaluations);
+		}
+
+		//Nothing a breeder uses should have to grow later on, however rarely it's used
+		breeder.childWorkspace.reserveCounts();
+		breeder.parentWorkspace.reserveCounts();
+		for(int i = 0; i < breeder.randomParents.size(); i++)
+			breeder.randomParents[i].reserveCounts();
+	}
+
+	clearMetrics(metrics);
+	childParentConfiguration.resize(populationSize);
+	childMutation.resize(populationSize);
+	childEvaluations.resize(populationSize);
+	childImprovement.resize(populationSize);
+	childPlaced.resize(populationSize);
+	parentBandit = OperatorBandit(numParentConfigurations);
+	mutationBandit = OperatorBandit(numPostMateMutations);
+}
+
+//Fills up the genePool with randomly generated configurations, then scores and ranks the whole pool in one go
+void GeneticPopulation::spawnAdditionalMembers(int numExisting)
+{
+	for(int i = numExisting; i < populationSize; i++)
+	{
+		breeders[0].childWorkspace.regenerate(random);
+		genePool.storeBoard(i, breeders[0].childWorkspace.getBoard().data());
+	}
+
+	genePool.evaluateAll();
+	orderGenePool();
 }
 
 //Wrapper method that spawns children, updates genePool, and checks for an optimal solution for n generations
-void GeneticPopulation::advancePopulation()
+//	A generation that gets stopped part way through is thrown away before it touches the genePool
+bool GeneticPopulation::advancePopulation()
 {
 	for(int i = 0; (i < numberOfGenerations) && (!optimalSolution); i++)
 	{
-		spawnChildren();
+		if(!spawnChildren())
+			return false;
 		improveGenePool();
 		checkOptimality();
+		generations++;
 	}
+
+	return true;
 }
 
-void GeneticPopulation::spawnChildren()
+void GeneticPopulation::setStopCondition(std::function<bool(long long)> stopCondition)
 {
-	int preMateMutationRate;
-	int postMateMutationRate;
-	int parentConfiguration;
-	bool parentOrder;
-	int numMutations;
-	int swapAnywayChance;
-	//These could be pointers
-	SudokuPuzzle parent1;
-	SudokuPuzzle parent2;
-	SudokuPuzzle child;
-	SudokuPuzzle tempChild;
+	shouldStop = stopCondition;
+}
 
-	childPool.clear();	//Empties childPool
+void GeneticPopulation::setScheduler(TaskScheduler *taskScheduler)
+{
+	scheduler = taskScheduler;
+}
+
+//Breeders poll on their own, with their own counts, so this can be called from several threads at once
+bool GeneticPopulation::pollStop(Breeder &breeder)
+{
+	long long spent;
+
+	if(!shouldStop)
+		return false;
+
+	spent = breeder.evaluations - breeder.polledEvaluations;
+	breeder.polledEvaluations = breeder.evaluations;
+
+	return shouldStop(spent);
+}
 
-	//Creates populationSize number of children
+long long GeneticPopulation::countEvaluations()
+{
+	long long total;
+
+	total = 0;
+	for(int b = 0; b < breeders.size(); b++)
+		total += breeders[b].evaluations;
+
+	return total;
+}
+
+//A copy of the genePool (boards and fitnesses, in slot order) plus everything that decides what happens to it next
+void GeneticPopulation::saveState(IslandState &state)
+{
+	state.generations = generations;
+	state.variance = variance;
+	random.getState(state.randomState);
+	state.boards.resize(populationSize * sizeOfBoard * sizeOfBoard);
 	for(int i = 0; i < populationSize; i++)
+		std::copy(genePool.getBoard(i), genePool.getBoard(i) + sizeOfBoard * sizeOfBoard, &state.boards[i * sizeOfBoard * sizeOfBoard]);
+	state.fitness.resize(populationSize);
+	for(int i = 0; i < populationSize; i++)
+		state.fitness[i] = genePool.getFitness(i);
+
+	state.operatorStatistics.clear();
+	if(operatorSelection == adaptiveOperators)
 	{
-		preMateMutationRate = rand() % 100;	//Mutation of the genome pre-mating
-		postMateMutationRate = rand() % 100;//Mutation of the genome post-mating
-		parentConfiguration = rand() % 4;	//Determines which parents a child will have
-		parentOrder = rand() % 2;			//Determines their order (A child will primarily be parent1)
-		numMutations = 0;
+		parentBandit.saveState(state.operatorStatistics);
+		mutationBandit.saveState(state.operatorStatistics);
+	}
+}
 
-		assert(genePool.size() == populationSize);
+//Breeds populationSize children into childPool
+//	The children are split into fixed shares, one per breeder, that only read the genePool and write their own slots, so the
+//	shares can be bred on different threads. Every breeder but a lone one draws from its own stream, split off of the
+//	population's generator in order each generation, so what gets bred depends on the seed and the number of breeders,
+//	never on how many threads there are or which of them gets to a share first
+bool GeneticPopulation::spawnChildren()
+{
+	std::chrono::high_resolution_clock::time_point phaseStart;
+	long long phaseEvaluations;
+	bool stopped;
+
+	phaseStart = std::chrono::high_resolution_clock::now();
+	phaseEvaluations = countEvaluations();
 
-		if(preMateMutationRate < variance)
-			parentConfiguration += 4;
+	assert(genePool.size() == populationSize);
 
-		//Parent config
-		switch(parentConfiguration)
+	//Picking an arm counts it as played, so the bandits pick for every child up front rather than being shared between breeders
+	if(operatorSelection == adaptiveOperators)
+	{
+		for(int i = 0; i < populationSize; i++)
 		{
-		case 0:
-			parent1 = genePool[0];	//Best 
-			parent2 = genePool[(int) (rand() % (populationSize / 10))];	//Best 10%
-			break;
-		case 1:
-			parent1 = genePool[0];
-			parent2 = genePool[(rand() % (populationSize - 1)) + 1];	//Anyone but the best
-			break;
-		case 2:
-			parent1 = genePool[(int) (rand() % (populationSize / 10))];
-			parent2 = genePool[rand() % populationSize];	//Anyone
-			break;
-		case 3:
-			parent1 = genePool[rand() % populationSize];
-			parent2 = genePool[rand() % populationSize];
-			break;
-		case 4:
-			parent1 = genePool[0];
-			parent2 = SudokuPuzzle(staticBoard);	//Random config
-			break;
-		case 5:
-			parent1 = genePool[rand() % populationSize];
-			parent2 = SudokuPuzzle(staticBoard);
-			break;
-		case 6:
-			parent1 = genePool[(int) (rand() % (populationSize / 10))];
-			parent2 = SudokuPuzzle(staticBoard);
-			break;
-		case 7:
-			parent1 = SudokuPuzzle(staticBoard);
-			parent2 = SudokuPuzzle(staticBoard);
-			break;
+			childParentConfiguration[i] = parentBandit.select();
+			childMutation[i] = mutationBandit.select();
 		}
+	}
 
-		//Swap the parents around
-		if(parentOrder)
+	genePool.getBest();		//Finds the best member now if it isn't known, so that breeding never writes to the genePool
+	if(breeders.size() > 1)
+		for(int b = 0; b < breeders.size(); b++)
+			breeders[b].stream = random.split();
+	runBreeders();
+
+	stopped = false;
+	for(int b = 0; b < breeders.size(); b++)
+	{
+		addMetrics(metrics, breeders[b].metrics);
+		clearMetrics(breeders[b].metrics);
+		stopped |= breeders[b].stopped;
+	}
+	if(stopped)
+		return false;
+
+	assert(childPool.size() == populationSize);
+	childPool.indexStored();
+	//Only the ranked replacement in improveGenePool looks at the children in order
+	if(selection == rankedSelection)
+		childPool.rank();
+
+	metrics.phases[spawnPhase].invocations++;
+	metrics.phases[spawnPhase].evaluations += countEvaluations() - phaseEvaluations;
+	metrics.phases[spawnPhase].nanoseconds += elapsedNanoseconds(phaseStart);
+
+	return true;
+}
+
+//The calling thread and the submitted tasks all claim shares from nextShare, so the calling thread only ever helps with this
+//	island's own shares (never another island's epoch), and only waits on shares some other thread is already breeding
+//	A task that gets to run after every share was claimed has nothing to do, and may even claim shares of a later generation,
+//	which is just as good since every share is bred with its own breeder whoever breeds it
+void GeneticPopulation::runBreeders()
+{
+	sharesBred = 0;
+	nextShare = 0;
+	if(scheduler)
+	{
+		for(int b = 1; b < breeders.size(); b++)
 		{
-			SudokuPuzzle tempSpecimen;
-	
-			tempSpecimen = parent1;
-			parent1 = parent2;
-			parent2 = tempSpecimen;
+			queuedBreedingTasks++;
+			scheduler->submit([this] { runBreedingTask(); });
 		}
+	}
+
+	breedShares();
+	std::unique_lock<std::mutex> lock(breedingMutex);
+	breedingDone.wait(lock, [this] { return sharesBred == breeders.size(); });
+}
+
+void GeneticPopulation::breedShares()
+{
+	int share;
+
+	while((share = nextShare++) < breeders.size())
+	{
+		breedChildren(breeders[share]);
+		if(++sharesBred == breeders.size())
+			notifyBreedingDone();
+	}
+}
 
-		child = parent1;
+void GeneticPopulation::runBreedingTask()
+{
+	breedShares();
+	if(--queuedBreedingTasks == 0)
+		notifyBreedingDone();
+}
 
-		if(preMateMutationRate < (int) (variance / 2))
-			child.randomize(rand() % (sizeOfBoard * sizeOfBoard));
-	
-		//Optimize, has to be better way
-		//Fit a random number of macroBlocks
+//Taking the lock first means a waiter can't miss the signal between checking its condition and going to sleep
+void GeneticPopulation::notifyBreedingDone()
+{
+	std::lock_guard<std::mutex> lock(breedingMutex);
+	breedingDone.notify_all();
+}
 
-			//Runs through a random range of macroBlocks
-			for(int j = 0; j < sizeOfBoard; j++)
+void GeneticPopulation::breedChildren(Breeder &breeder)
+{
+	breeder.stopped = false;
+	for(int i = breeder.firstChild; i < breeder.lastChild; i++)
+	{
+		if(pollStop(breeder))
+		{
+			breeder.stopped = true;
+			return;
+		}
+
+		breedChild(breeder, i);
+	}
+}
+
+//Each child is bred in the breeder's childWorkspace, where every candidate swap is evaluated in place and only committed if it's
+//	kept, and is then copied into its slot in the childPool. Nothing is allocated along the way.
+void GeneticPopulation::breedChild(Breeder &breeder, int i)
+{
+	int preMateMutationRate;
+	int postMateMutationRate;
+	int parentConfiguration;
+	bool parentOrder;
+	int numMutations;
+	int swapAnywayChance;
+	const Cell *parent1;
+	const Cell *parent2;
+	const Cell *tempSpecimen;
+	int parent1Fitness;
+	int parent2Fitness;
+	int tempFitness;
+	unsigned long long parent1Hash;
+	unsigned long long parent2Hash;
+	unsigned long long tempHash;
+	SwapMove move;
+	SudokuPuzzle &child = breeder.childWorkspace;
+	RandomGenerator &random = *breeder.random;
+	std::chrono::high_resolution_clock::time_point operatorStart;
+	long long operatorEvaluations;
+	long long crossoverEvaluations;
+	long long mutationEvaluations;
+	int mutationFitness;
+
+	operatorStart = std::chrono::high_resolution_clock::now();
+	operatorEvaluations = breeder.evaluations;
+	preMateMutationRate = random.nextInt(100);	//Mutation of the genome pre-mating
+	postMateMutationRate = random.nextInt(100);	//Mutation of the genome post-mating
+	parentConfiguration = random.nextInt(4);	//Determines which parents a child will have
+	parentOrder = random.nextInt(2) != 0;		//Determines their order (A child will primarily be parent1)
+	numMutations = 0;
+
+	if(preMateMutationRate < variance)
+		parentConfiguration += 4;
+
+	//The bandits picked both operators instead (see spawnChildren), the draws above still happen so the rest of the sequence is the same either way
+	if(operatorSelection == adaptiveOperators)
+	{
+		parentConfiguration = childParentConfiguration[i];
+		postMateMutationRate = childMutation[i];
+	}
+
+	//Parent config
+	switch(parentConfiguration)
+	{
+	case 0:
+		selectParent(genePool.getBest(), parent1, parent1Fitness, parent1Hash);	//Best 
+		selectParent(selectFit(random), parent2, parent2Fitness, parent2Hash);	//Best 10%
+		break;
+	case 1:
+		selectParent(genePool.getBest(), parent1, parent1Fitness, parent1Hash);
+		selectParent(selectAny(true, random), parent2, parent2Fitness, parent2Hash);	//Anyone but the best
+		break;
+	case 2:
+		selectParent(selectFit(random), parent1, parent1Fitness, parent1Hash);
+		selectParent(selectAny(false, random), parent2, parent2Fitness, parent2Hash);	//Anyone
+		break;
+	case 3:
+		selectParent(selectAny(false, random), parent1, parent1Fitness, parent1Hash);
+		selectParent(selectAny(false, random), parent2, parent2Fitness, parent2Hash);
+		break;
+	case 4:
+		selectParent(genePool.getBest(), parent1, parent1Fitness, parent1Hash);
+		selectRandomParent(breeder, 1, parent2, parent2Fitness, parent2Hash);	//Random config
+		break;
+	case 5:
+		selectParent(selectAny(false, random), parent1, parent1Fitness, parent1Hash);
+		selectRandomParent(breeder, 1, parent2, parent2Fitness, parent2Hash);
+		break;
+	case 6:
+		selectParent(selectFit(random), parent1, parent1Fitness, parent1Hash);
+		selectRandomParent(breeder, 1, parent2, parent2Fitness, parent2Hash);
+		break;
+	case 7:
+	default:
+		selectRandomParent(breeder, 0, parent1, parent1Fitness, parent1Hash);
+		selectRandomParent(breeder, 1, parent2, parent2Fitness, parent2Hash);
+		break;
+	}
+
+	//Swap the parents around
+	if(parentOrder)
+	{
+		tempSpecimen = parent1;
+		parent1 = parent2;
+		parent2 = tempSpecimen;
+		tempFitness = parent1Fitness;
+		parent1Fitness = parent2Fitness;
+		parent2Fitness = tempFitness;
+		tempHash = parent1Hash;
+		parent1Hash = parent2Hash;
+		parent2Hash = tempHash;
+	}
+
+	child.loadBoard(parent1, parent1Fitness, parent1Hash);
+
+	if(preMateMutationRate < (int) (variance / 2))
+		child.randomize(random.nextInt(sizeOfBoard * sizeOfBoard), random);
+
+	//Optimize, has to be better way
+	//Fit a random number of macroBlocks
+
+	//Random chances to perform each of the below swaps anyway, drawn all at once
+	random.fillInts(breeder.randomDraws.data(), sizeOfBoard * sizeOfBoard, randomPercent);
+
+		//Runs through a random range of macroBlocks
+		for(int j = 0; j < sizeOfBoard; j++)
+		{
+			for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
 			{
-				for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
-				{
-	
-					swapAnywayChance = rand() % randomPercent;			//Random chance to perform the below swap anyway
-					//if(iterateBackwards)
-					//	tempChild = SudokuPuzzle((startMacroBlock - j) % sizeOfBoard, (startSwap + k) % sizeOfBoard, (startSwap + l) % sizeOfBoard, child);
-					//else
-					tempChild = child;
-					tempChild.replaceCell(j, k, parent2.getCellAt(j, k));
-
-					if ((tempChild < child) || (!swapAnywayChance))	//Compares the two, only updates if the new configuration is better than the current one.
-							child = tempChild;
-				}
+				swapAnywayChance = breeder.randomDraws[convertCoordinates(k, j, sizeOfBoard)];	//Random chance to perform the below swap anyway
+				move = child.getReplaceMove(j, k, parent2[definition->getCellIndex(j, k)]);
+
+				//Only commits the move if the new configuration is better than the current one. Moves that can't be (neither cell is conflicted) aren't even scored
+				if((!swapAnywayChance) || (child.canImprove(move) && (child.evaluateMove(move) < 0)))
+					child.applyMove(move);
 			}
+		}
 
-		
-		//Mutates the created child
-		switch(postMateMutationRate)
-		{
-		case 0:
-			numMutations += 2 * sizeOfBoard;
-		case 1:
-			numMutations += sizeOfBoard;
-		case 2:
-			numMutations++;
-		case 3:
-			numMutations++;
-		case 4:
-			numMutations++;
-		case 5:
-			numMutations++;
-		case 6:
-			numMutations++;
-		case 7:
-			numMutations++;
-		case 8:
-			numMutations++;
-			child.randomize(numMutations);
+	//The parent configuration gets the credit (or blame) for the crossover and pre-mate mutation
+	OperatorCounters &parentCounters = breeder.metrics.parentConfigurations[parentConfiguration];
+	parentCounters.invocations++;
+	crossoverEvaluations = breeder.evaluations - operatorEvaluations;
+	parentCounters.evaluations += crossoverEvaluations;
+	countFitnessChange(parentCounters, parent1Fitness, child.getFitness());
+	parentCounters.nanoseconds += elapsedNanoseconds(operatorStart);
+	operatorStart = std::chrono::high_resolution_clock::now();
+	operatorEvaluations = breeder.evaluations;
+	mutationFitness = child.getFitness();
+
+	//Mutates the created child
+	switch(postMateMutationRate)
+	{
+	case 0:
+		numMutations += 2 * sizeOfBoard;
+	case 1:
+		numMutations += sizeOfBoard;
+	case 2:
+		numMutations++;
+	case 3:
+		numMutations++;
+	case 4:
+		numMutations++;
+	case 5:
+		numMutations++;
+	case 6:
+		numMutations++;
+	case 7:
+		numMutations++;
+	case 8:
+		numMutations++;
+		child.randomize(numMutations, random);
+		break;
+	case 9:
+	case 10:
+	case 11:
+		if(runLocalSearch(breeder, child))
 			break;
-		case 9:
-		case 10:
-		case 11:
-			for(int j = 0; j < sizeOfBoard; j++)
+		for(int j = 0; j < sizeOfBoard; j++)
+		{
+			for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
 			{
-				for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
+				for(int l = (k + 1); l <= sizeOfBoard; l++)
 				{
-					for(int l = (k + 1); l <= sizeOfBoard; l++)
-					{
-						swapAnywayChance = rand() % sizeOfBoard;			//Random chance to perform the below swap anyway
-						tempChild = child;
-						tempChild.replaceCell(j, k, l);
-						if((tempChild < child) || (!swapAnywayChance))	//Compares the two, only updates if the new configuration is better than the current one.
-							child = tempChild;
-					}
+					swapAnywayChance = random.nextInt(sizeOfBoard);			//Random chance to perform the below swap anyway
+					move = child.getReplaceMove(j, k, l);
+					if((!swapAnywayChance) || (child.canImprove(move) && (child.evaluateMove(move) < 0)))	//Only commits the move if the new configuration is better than the current one.
+						child.applyMove(move);
 				}
 			}
+		}
+		break;
+	case 12:
+		if(runLocalSearch(breeder, child))
 			break;
-		case 12:
-			for(int j = 0; j < sizeOfBoard; j++)
+		breeder.parentWorkspace.loadBoard(parent2, parent2Fitness, parent2Hash);
+		for(int j = 0; j < sizeOfBoard; j++)
+		{
+			for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
 			{
-				for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
+				for(int l = (k + 1); l < sizeOfBoard; l++)
 				{
-					for(int l = (k + 1); l < sizeOfBoard; l++)
+					swapAnywayChance = random.nextInt(2);			//Random chance to perform the below swap anyway
+					//The candidate is parent2 with a swap, so it's scored off of parent2 and only copied over if it's kept
+					move = breeder.parentWorkspace.getSwapMove(j, k, l);
+					if ((breeder.parentWorkspace.getFitness() + breeder.parentWorkspace.evaluateMove(move) < child.getFitness()) || (!swapAnywayChance))
 					{
-						swapAnywayChance = rand() % 2;			//Random chance to perform the below swap anyway
-						tempChild = SudokuPuzzle(j, k, l, parent2);
-						if ((tempChild < child) || (!swapAnywayChance))	//Compares the two, only updates if the new configuration is better than the current one.
-							child = tempChild;
+						child = breeder.parentWorkspace;
+						child.applyMove(move);
 					}
 				}
 			}
+		}
+		break;
+	case 13:
+	case 14:
+		if(runLocalSearch(breeder, child))
 			break;
-		case 13:
-		case 14:
-			for(int j = 0; j < sizeOfBoard; j++)
+		for(int j = 0; j < sizeOfBoard; j++)
+		{
+			for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
 			{
-				for(int k = 0; k < sizeOfBoard; k++)	//Tries to swap every pair
+				for(int l = (k + 1); l < sizeOfBoard; l++)
 				{
-					for(int l = (k + 1); l < sizeOfBoard; l++)
-					{
-						swapAnywayChance = rand() % 2;			//Random chance to perform the below swap anyway
-						tempChild = SudokuPuzzle(j, k, l, child);
-						if ((tempChild < child) || (!swapAnywayChance))	//Compares the two, only updates if the new configuration is better than the current one.
-							child = tempChild;
-					}
+					swapAnywayChance = random.nextInt(2);			//Random chance to perform the below swap anyway
+					move = child.getSwapMove(j, k, l);
+					if ((!swapAnywayChance) || (child.canImprove(move) && (child.evaluateMove(move) < 0)))	//Only commits the move if the new configuration is better than the current one.
+						child.applyMove(move);
 				}
 			}
-			break;
 		}
+		break;
+	}
+
+	OperatorCounters &mutationCounters = breeder.metrics.postMateMutations[std::min(postMateMutationRate, numPostMateMutations - 1)];
+	mutationCounters.invocations++;
+	mutationEvaluations = breeder.evaluations - operatorEvaluations;
+	mutationCounters.evaluations += mutationEvaluations;
+	countFitnessChange(mutationCounters, mutationFitness, child.getFitness());
+	countFitnessChange(breeder.metrics.phases[spawnPhase], parent1Fitness, child.getFitness());
+	mutationCounters.nanoseconds += elapsedNanoseconds(operatorStart);
+
+	//Puts the child in the childPool, remembering what it was bred with in case it makes it into the genePool
+	childPool.storeUnindexed(i, child);
+	childParentConfiguration[i] = parentConfiguration;
+	childMutation[i] = std::min(postMateMutationRate, numPostMateMutations - 1);
+	childEvaluations[i] = crossoverEvaluations + mutationEvaluations;
+	childImprovement[i] = 0;
+	childPlaced[i] = false;
+}
 
-		//Puts the child in the childPool
-		childPool.push_back(child);
+//Tabu search gets an iteration per row, annealing (whose iterations are much cheaper) gets one per cell
+bool GeneticPopulation::runLocalSearch(Breeder &breeder, SudokuPuzzle &child)
+{
+	LocalSearchOperator chosen;
+	RandomGenerator &random = *breeder.random;
+
+	chosen = localSearchOperator;
+	if(chosen == mixedLocalSearch)
+		chosen = (LocalSearchOperator) random.nextInt(mixedLocalSearch);
+
+	switch(chosen)
+	{
+	case tabuLocalSearch:
+		breeder.localSearch.tabuSearch(child, sizeOfBoard, random);
+		return true;
+	case annealingLocalSearch:
+		breeder.localSearch.simulatedAnnealing(child, sizeOfBoard * sizeOfBoard, random);
+		return true;
+	default:
+		return false;
 	}
+}
 
-	assert(childPool.size() == populationSize);
-	//Orders the childPool
-	std::sort(childPool.begin(), childPool.end());
+//Under truncationSelection the best 10% are partitioned off but not ordered, which is all a uniform pick among them needs
+int GeneticPopulation::selectFit(RandomGenerator &random)
+{
+	switch(selection)
+	{
+	case tournamentSelection:
+		return genePool.tournament(tournamentSize, random, true);
+	case rankWeightedSelection:
+		return genePool.getRanked(std::min(populationSize - 1, (int) (std::upper_bound(rankCdf.begin(), rankCdf.end(), random.nextDouble() * rankCdf.back()) - rankCdf.begin())));
+	default:
+		return genePool.getRanked(random.nextInt(eliteCount));
+	}
+}
+
+//A uniformly random rank is just a uniformly random slot, so only the ranked strategy goes through the ranking
+int GeneticPopulation::selectAny(bool excludeBest, RandomGenerator &random)
+{
+	int slot;
+
+	if(selection == rankedSelection)
+		return genePool.getRanked(excludeBest ? random.nextInt(populationSize - 1) + 1 : random.nextInt(populationSize));
+
+	if(!excludeBest)
+		return random.nextInt(populationSize);
+
+	//Draws from one fewer slot and skips over the best
+	slot = random.nextInt(populationSize - 1);
+	if(slot >= genePool.getBest())
+		slot++;
+
+	return slot;
+}
+
+void GeneticPopulation::selectParent(int slot, const Cell *&parent, int &parentFitness, unsigned long long &parentHash)
+{
+	parent = genePool.getBoard(slot);
+	parentFitness = genePool.getFitness(slot);
+	parentHash = genePool.getHash(slot);
+}
+
+void GeneticPopulation::selectRandomParent(Breeder &breeder, int which, const Cell *&parent, int &parentFitness, unsigned long long &parentHash)
+{
+	breeder.randomParents[which].regenerate(*breeder.random);
+	parent = breeder.randomParents[which].getBoard().data();
+	parentFitness = breeder.randomParents[which].getFitness();
+	parentHash = breeder.randomParents[which].getHash();
 }
 
 //Swaps children with members of the genePool
@@ -232,30 +648,31 @@ void GeneticPopulation::improveGenePool()
 	int swapsMade;
 	int index;
 	int swapAnyways;
+	std::chrono::high_resolution_clock::time_point phaseStart;
 
+	phaseStart = std::chrono::high_resolution_clock::now();
 	swapsMade = 0;
-	numSwaps = (int) (rand() % minimumImprovement) + minimumImprovement;
+	numSwaps = (int) (random.nextInt(populationSize) * .2) + minimumImprovement;
 
 	//Random chance to compare the best two
 	if(numSwaps % 2 == 0)
 	{
-		swapAnyways = rand() % 100;
-		if((childPool[0] < genePool[0]) || (!swapAnyways))
-		{
-			genePool[0] = childPool[0];
+		swapAnyways = random.nextInt(100);
+		if(((childPool.getFitness(childPool.getBest()) < genePool.getFitness(genePool.getBest())) || (!swapAnyways)) && replaceMember(genePool.getBest(), childPool.getBest()))
 			swapsMade++;
-		}
 	}
 
-	//Compares SudokuPuzzles at arbitrary positions within the two arrays
-	for(int i = 0; i < numSwaps; i++)
+	if(selection != rankedSelection)
+		replaceByTournament(numSwaps, swapsMade);
+	else
 	{
-		index = rand() % populationSize;
-		swapAnyways = rand() % 100;
-		if((childPool[index] < genePool[index]) || (!swapAnyways))	//Updates the genePool 
+		//Compares SudokuPuzzles at arbitrary positions within the two arrays
+		for(int i = 0; i < numSwaps; i++)
 		{
-			genePool[index] = childPool[index];
-			swapsMade++;
+			index = random.nextInt(populationSize);
+			swapAnyways = random.nextInt(100);
+			if(((childPool.getFitness(childPool.getRanked(index)) < genePool.getFitness(genePool.getRanked(index))) || (!swapAnyways)) && replaceMember(genePool.getRanked(index), childPool.getRanked(index)))	//Updates the genePool 
+				swapsMade++;
 		}
 	}
 
@@ -265,7 +682,68 @@ void GeneticPopulation::improveGenePool()
 	else
 		resetVariance();
 
-	sortGenePool();
+	orderGenePool();
+	if(operatorSelection == adaptiveOperators)
+		creditOperators();
+
+	metrics.phases[improvePhase].invocations++;
+	metrics.phases[improvePhase].accepted += swapsMade;
+	metrics.phases[improvePhase].nanoseconds += elapsedNanoseconds(phaseStart);
+}
+
+//An operator only pays off if the children it breeds improve the genePool, so that's what it's credited with, per evaluation spent
+//	breeding them. Evaluations stand in for CPU time (they track it closely, see IslandMetrics), and unlike the clock they keep
+//	runs reproducible. Both of a child's operators share its credit, and children that didn't make it in earn nothing
+void GeneticPopulation::creditOperators()
+{
+	double reward;
+
+	for(int i = 0; i < populationSize; i++)
+	{
+		reward = childImprovement[i] / (double) (childEvaluations[i] + 1);
+		parentBandit.update(childParentConfiguration[i], reward);
+		mutationBandit.update(childMutation[i], reward);
+	}
+}
+
+//The unsorted counterpart of comparing children and members of equal rank: a fit child against an unfit member
+//	The best member is never the loser, unless the child beats it
+void GeneticPopulation::replaceByTournament(int numSwaps, int &swapsMade)
+{
+	int childSlot;
+	int loserSlot;
+	int swapAnyways;
+
+	for(int i = 0; i < numSwaps; i++)
+	{
+		childSlot = childPool.tournament(tournamentSize, random, true);
+		loserSlot = genePool.tournament(tournamentSize, random, false);
+		swapAnyways = random.nextInt(100);
+
+		if((childPool.getFitness(childSlot) < genePool.getFitness(loserSlot)) || (!swapAnyways && (loserSlot != genePool.getBest())))
+		{
+			if(replaceMember(loserSlot, childSlot))
+				swapsMade++;
+		}
+	}
+}
+
+//Children often come out identical to a parent (every swap was rejected), and letting copies of the same board pile up
+//	in the genePool costs diversity for nothing, so a board the genePool already has is turned away
+//	The child's board is handed over rather than copied, leaving its childPool slot with the board it replaced, so a child that
+//	made it in once (and has since been replaced itself) can't be placed again
+bool GeneticPopulation::replaceMember(int slot, int childSlot)
+{
+	if(childPlaced[childSlot] || genePool.containsHash(childPool.getHash(childSlot)))
+		return false;
+
+	childImprovement[childSlot] = std::max(0, genePool.getFitness(slot) - childPool.getFitness(childSlot));
+	countFitnessChange(metrics.phases[improvePhase], genePool.getFitness(slot), childPool.getFitness(childSlot));
+	genePool.takeSlot(slot, childPool, childSlot);
+	childPlaced[childSlot] = true;
+	metrics.parentConfigurations[childParentConfiguration[childSlot]].accepted++;
+	metrics.postMateMutations[childMutation[childSlot]].accepted++;
+	return true;
 }
 
 //I'm not sure if this method works properly
@@ -280,19 +758,76 @@ void GeneticPopulation::improveGenePool()
 //	}
 //}
 
-//Returns the best 50% of the genePool
-std::vector<SudokuPuzzle> GeneticPopulation::getPopulationSegment()
+//Returns the best member plus (numMigrants - 1) others, the population itself keeps all of its members
+std::vector<SudokuPuzzle> GeneticPopulation::getMigrants(int numMigrants)
 {
+	std::vector<int> slots;
+	std::vector<SudokuPuzzle> migrants;
+	int best;
+
+	best = genePool.getBest();
+	slots.push_back(best);
+	for(int i = 0; i < populationSize; i++)
+		if(i != best)
+			slots.push_back(i);
+
 	//Shuffle everything but the best for a good representation of the population (avoids convergance of local maxima)
-	std::random_shuffle(++genePool.begin(), genePool.end());
-	genePool.resize(populationSize / 2);
-	return genePool;
+	std::shuffle(++slots.begin(), slots.end(), random);
+	for(int i = 0; i < numMigrants; i++)
+		migrants.push_back(genePool.extract(slots[i]));
+
+	return migrants;
 }
 
-//Sorting the genePool allows us to find the best and worst members simply be indexing into the genePool
-void GeneticPopulation::sortGenePool()
+//Migrants take over the slots of the least fit members, in place
+//	Partitioning is enough to find those, whatever the selection strategy keeps the pool ordered by
+void GeneticPopulation::acceptMigrants(const std::vector<SudokuPuzzle> &migrants)
 {
-	std::sort(genePool.begin(), genePool.end());
+	int numAccepted;
+	int numStored;
+	int slot;
+
+	numAccepted = std::min((int) migrants.size(), populationSize);
+	genePool.partition(populationSize - numAccepted);
+
+	//Migrants this population already has (its own best coming back around, for instance) are passed on
+	numStored = 0;
+	for(int i = 0; i < numAccepted; i++)
+	{
+		if(!genePool.containsHash(migrants[i].getHash()))
+		{
+			slot = genePool.getRanked(populationSize - 1 - numStored++);
+			countFitnessChange(metrics.phases[migrationPhase], genePool.getFitness(slot), migrants[i].getFitness());
+			genePool.store(slot, migrants[i]);
+		}
+	}
+	metrics.phases[migrationPhase].accepted += numStored;
+
+	orderGenePool();
+	checkOptimality();
+}
+
+SudokuPuzzle GeneticPopulation::getBest()
+{
+	return genePool.extract(genePool.getBest());
+}
+
+//Ranking the genePool allows us to find the best and worst members simply by rank, without moving any boards around
+//	The best member is tracked by the pool itself, so tournaments don't need any ordering, and truncation only needs the elite split off
+void GeneticPopulation::orderGenePool()
+{
+	switch(selection)
+	{
+	case rankedSelection:
+	case rankWeightedSelection:
+		genePool.rank();
+		break;
+	case truncationSelection:
+		genePool.partition(eliteCount);
+		break;
+	default:
+		break;
+	}
 }
 
 void GeneticPopulation::resetVariance()
@@ -310,10 +845,20 @@ void GeneticPopulation::incrementVariance()
 
 void GeneticPopulation::checkOptimality()
 {
-	if(genePool[0].getFitness() == 0)
+	if(genePool.getFitness(genePool.getBest()) == 0)
 		optimalSolution = true;
 }
 bool GeneticPopulation::hasOptimal()
 {
 	return optimalSolution;
+}
+
+int GeneticPopulation::getGenerations()
+{
+	return generations;
+}
+
+IslandMetrics &GeneticPopulation::getMetrics()
+{
+	return metrics;
 }
\ No newline at end of file
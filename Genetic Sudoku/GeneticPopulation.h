@@ -3,41 +3,125 @@
 #include <math.h>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
+#include "BinaryFormat.h"
+#include "LocalSearch.h"
+#include "Metrics.h"
+#include "OperatorBandit.h"
+#include "SolverConfig.h"
+#include "SpecimenPool.h"
 #include "SudokuPuzzle.h"
-
-//Make sure populationSize is an even number, threads return exactly half of this. These numbers can be tweaked
-#define populationSize 130	
-#define numberOfGenerations 100
-//minimumImprovement defines the minimum number of replacements per generation that need to happen, otherwise increase the randomness of pre-mate genome mutation
-#define minimumImprovement populationSize * .2
-#define randomPercent 20
+#include "TaskScheduler.h"
 
 //Probably could have used Math.e instead
 #define e 2.71828182845904523536
+//Members drawn per tournament, for tournamentSelection
+#define tournamentSize 3
+//How much more likely the best member is to be picked than an average one under rankWeightedSelection (between 1 and 2)
+#define rankSelectionPressure 1.5
+//Boards whose fitness each population remembers (see FitnessCache)
+#define fitnessCacheSize 4096
 
 class GeneticPopulation
 {
+	friend class Benchmark;						//Runs whole generations directly, to count what they allocate
 private:
-	std::vector<SudokuPuzzle> genePool;			//The current gene pool
-	std::vector<SudokuPuzzle> childPool;		//The collection of children that are spawned every generation
-	std::vector<int> staticBoard;				//The initial board which should be shared across all members of the population
+	//Everything a share of each generation's children is bred with, so that shares can be bred on different threads at once
+	//	A Breeder only ever reads the genePool, and only writes its own slots of the childPool (see spawnChildren)
+	struct Breeder
+	{
+		SudokuPuzzle childWorkspace;			//Children are bred here (where swaps can be scored incrementally) and then stored into the childPool
+		SudokuPuzzle parentWorkspace;			//Used when a parent has to be bred on directly rather than just read from
+		std::vector<SudokuPuzzle> randomParents;	//Scratch space for the randomly generated parents
+		std::vector<int> randomDraws;			//Batch of pre-drawn random numbers, refilled once per child instead of drawing one at a time
+		FitnessCache fitnessCache;				//Fitnesses of boards this breeder has fully evaluated, shared by its workspaces
+		LocalSearch localSearch;
+		RandomGenerator stream;					//Split off of the population's generator every generation, when there's more than one breeder
+		RandomGenerator *random;				//What this breeder draws from: stream, or the population's own generator if it's the only breeder
+		IslandMetrics metrics;					//Operator counters of the children bred since they were last added into the population's
+		long long evaluations;					//Fitness evaluations made by the workspaces, which all count into this
+		long long polledEvaluations;			//evaluations as of the last poll
+		int firstChild;							//The childPool slots this breeder fills, from firstChild up to (not including) lastChild
+		int lastChild;
+		bool stopped;							//Whether the stop condition cut this breeder's last generation short
+	};
+
+	BoardArenaPtr boardArena;					//Every board of both pools, so children can be moved into the genePool without being copied
+	SpecimenPool genePool;						//The current gene pool
+	SpecimenPool childPool;						//The collection of children that are spawned every generation, slots are reused across generations
+	std::vector<Breeder> breeders;				//Allocated once, the workspaces point into them so they never move
+	TaskScheduler *scheduler;					//Where breeders beyond the first are run, null to breed every share on the calling thread
+	std::atomic<int> nextShare;					//Index of the next breeder whose share of this generation hasn't been claimed yet
+	std::atomic<int> sharesBred;				//Shares of this generation that have been bred
+	std::atomic<int> queuedBreedingTasks;		//Breeding tasks submitted but not finished, which can outlast the generation they were submitted for
+	std::mutex breedingMutex;					//Only taken to sleep on breedingDone, or to wake whoever does
+	std::condition_variable breedingDone;		//Signalled when the last share of a generation is bred, and when the last breeding task finishes
+	PuzzleDefinitionPtr definition;				//The initial board which is shared across all members of the population
+	RandomGenerator random;						//Every random decision the population makes comes from here (or from streams split off of it), so runs are reproducible per seed
+	IslandMetrics metrics;						//What each operator and phase has done, see MetricsRegistry
+	std::vector<unsigned char> childParentConfiguration;	//For each childPool slot, the parentConfiguration its child was bred with
+	std::vector<unsigned char> childMutation;	//For each childPool slot, the post-mate mutation its child got
+	std::vector<long long> childEvaluations;	//For each childPool slot, the evaluations it took to breed its child
+	std::vector<int> childImprovement;			//For each childPool slot, how much better its child was than the member it replaced (0 if it didn't)
+	std::vector<unsigned char> childPlaced;		//For each childPool slot, whether its child was moved into the genePool (its slot holds the replaced board since)
+	std::function<bool(long long)> shouldStop;	//Polled between children with the evaluations made since the last poll, true to stop
+	LocalSearchOperator localSearchOperator;	//Which local search the post-mate mutations use
+	SelectionStrategy selection;				//How parents are picked and how children replace gene pool members
+	OperatorSelection operatorSelection;		//Whether the parent configurations and post-mate mutations are picked by the bandits below
+	OperatorBandit parentBandit;				//Learns which parent configurations pay off, an arm per configuration
+	OperatorBandit mutationBandit;				//Learns which post-mate mutations pay off, an arm per case (plus one for none)
+	std::vector<double> rankCdf;				//For rankWeightedSelection, the chance of picking any of ranks 0..n, worked out once
+	int eliteCount;								//Size of the "best 10%" parents are drawn from
 	double variance;							//Used to test the randomness of pre-mate genome mutation
+	int populationSize;							//These come from the SolverConfig, see there
+	int numberOfGenerations;
+	int randomPercent;
+	double minimumImprovement;					//The minimum number of replacements per generation that need to happen, otherwise increase the randomness of pre-mate genome mutation
 	bool optimalSolution;
+	int generations;							//Generations run so far, across every call to advancePopulation
 	int sizeOfBoard;
 	int sizeOfMacroBlock;						
 
+	void initialize(SudokuPuzzle, const SolverConfig &);	//Copies the settings and allocates everything, using some puzzle as the template for the workspaces
 	//void mutateSpecimen(SudokuPuzzle &, int);	//Swaps around some number of cells in some SudokuPuzzle configuration
 	void checkOptimality();						//Determines if an optimal solution has been found
-	void sortGenePool();						//Sorts the genePool so that the most-fit members is at index 0, and the least-fit is at the end
-	void spawnAdditionalMembers();				//When a GeneticPopulation is given an initial array(via the constructor), create additional members until populationSize has been reached
+	void orderGenePool();						//Orders the genePool as much as the selection strategy needs, which may be not at all
+	int selectFit(RandomGenerator &);			//Slot of one of the fittest members (the best 10%, or a sample biased towards them)
+	int selectAny(bool, RandomGenerator &);		//Slot of any member, or any but the best if true
+	void selectParent(int, const Cell *&, int &, unsigned long long &);		//Points a parent at the board, fitness and hash of some slot of the genePool
+	void selectRandomParent(Breeder &, int, const Cell *&, int &, unsigned long long &);	//Points a parent at a freshly randomized board (one of the breeder's randomParents)
+	void spawnAdditionalMembers(int);			//When a GeneticPopulation is given an initial array(via the constructor), create additional members until populationSize has been reached
 	void incrementVariance();					//If not enough swaps have been made, increase the randomness of pre-mate genome mutation
 	void resetVariance();						//If enough swaps have been made, reset the randomness of pre-mate genome mutation
-	void spawnChildren();						//Mates parents from genePool and populates the childPool
+	bool pollStop(Breeder &);					//Asks shouldStop (if there is one) whether to give up, handing it the evaluations the breeder made since last time
+	void creditOperators();						//Rewards the bandits for the operators of every child of the last generation
+	bool spawnChildren();						//Mates parents from genePool and populates the childPool, false if it was stopped part way through
+	void runBreeders();							//Has every breeder breed its share of the children, on the scheduler if there is one
+	void breedShares();							//Claims and breeds shares of this generation until none are left
+	void runBreedingTask();						//What a breeding task submitted to the scheduler runs
+	void notifyBreedingDone();					//Wakes whoever is sleeping on breedingDone
+	void breedChildren(Breeder &);				//Breeds a breeder's share of the children, stopping early if pollStop says so
+	void breedChild(Breeder &, int);			//Breeds the child of some childPool slot
+	bool runLocalSearch(Breeder &, SudokuPuzzle &);	//Runs the configured LocalSearch operator on a child, false if the exhaustive scans should be used instead
 	void improveGenePool();						//Swaps children with members of the current gene pool
-	void advancePopulation();					//Caller function to advance the current function for n generations
+	void replaceByTournament(int, int &);		//Some number of tournament-picked children take the place of tournament-picked losers
+	bool replaceMember(int, int);				//Copies a child over a genePool slot, unless the genePool already has that board
 public:
-	GeneticPopulation(std::vector<SudokuPuzzle>);
+	GeneticPopulation(std::vector<SudokuPuzzle>, const SolverConfig &, unsigned long long);	//Initial configurations, settings, and the seed for the population's RandomGenerator
+	GeneticPopulation(const IslandState &, PuzzleDefinitionPtr, const SolverConfig &);		//Resumes a population saved with saveState (with the same settings)
+	~GeneticPopulation();
 
-	std::vector<SudokuPuzzle> getPopulationSegment();	//Returns a subset of the generated population to the PopulationCongregator
+	//A GeneticPopulation is long-lived: it keeps its pools, buffers and variance between calls to advancePopulation,
+	//	and only exchanges a few migrants with the other populations in between
+	bool advancePopulation();							//Advances the population for numberOfGenerations generations (or until an optimal solution is found), false if it was stopped part way through
+	void setStopCondition(std::function<bool(long long)>);	//Polled between children, a stop abandons the generation underway and leaves the genePool as it was
+	void setScheduler(TaskScheduler *);					//Where a generation's children are bred, when they're split among more than one breeder
+	std::vector<SudokuPuzzle> getMigrants(int);			//Copies of the best member plus randomly chosen others, to send to other populations
+	void acceptMigrants(const std::vector<SudokuPuzzle> &);	//Replaces the least fit members with migrants from other populations
+	SudokuPuzzle getBest();								//Copy of the most fit member
 	bool hasOptimal();									//Whether or not an optimal solution has been found
+	int getGenerations();
+	long long countEvaluations();						//Fitness evaluations made by every breeder so far, full or of a single swap
+	void saveState(IslandState &);						//Everything needed to resume the population later, only valid between calls to advancePopulation
+	IslandMetrics &getMetrics();						//Only to be touched by whoever is running the population
 };
\ No newline at end of file
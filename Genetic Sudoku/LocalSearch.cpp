@@ -0,0 +1,129 @@
+#include "LocalSearch.h"
+
+LocalSearch::LocalSearch()
+{
+	bestFitness = INT_MAX;
+	bestHash = 0;
+}
+
+LocalSearch::LocalSearch(int sizeOfBoard)
+{
+	conflictedCells.reserve(sizeOfBoard * sizeOfBoard);
+	tabuUntil.resize(sizeOfBoard * sizeOfBoard);
+	bestBoard.resize(sizeOfBoard * sizeOfBoard);
+	bestFitness = INT_MAX;
+	bestHash = 0;
+}
+
+void LocalSearch::rememberIfBest(SudokuPuzzle &puzzle)
+{
+	if(puzzle.getFitness() < bestFitness)
+	{
+		bestFitness = puzzle.getFitness();
+		bestBoard = puzzle.getBoard();
+		bestHash = puzzle.getHash();
+	}
+}
+
+//Tabu search: moving a cell makes it tabu for a few iterations, which keeps the search from just undoing its last move
+//	A tabu move is still allowed if it would beat the best board found so far (aspiration)
+void LocalSearch::tabuSearch(SudokuPuzzle &puzzle, int iterations, RandomGenerator &random)
+{
+	PuzzleDefinitionPtr definition;
+	SwapMove move;
+	SwapMove bestMove;
+	int bestDelta;
+	int numTies;
+	int delta;
+
+	definition = puzzle.getDefinition();
+	tabuUntil.assign(puzzle.getSizeOfBoard() * puzzle.getSizeOfBoard(), 0);
+	bestFitness = INT_MAX;
+	rememberIfBest(puzzle);
+
+	for(int iteration = 1; (iteration <= iterations) && (puzzle.getFitness() > 0); iteration++)
+	{
+		//Copied, since the puzzle's own list changes as soon as a move is made
+		conflictedCells = puzzle.getConflictedCells();
+		bestDelta = INT_MAX;
+		numTies = 0;
+
+		for(int i = 0; i < conflictedCells.size(); i++)
+		{
+			const std::vector<int> &freeCells = definition->getFreeCells(definition->getBlock(conflictedCells[i]));
+
+			for(int j = 0; j < freeCells.size(); j++)
+			{
+				move = puzzle.getCellSwapMove(conflictedCells[i], freeCells[j]);
+				if(move.originIndex < 0)
+					continue;
+
+				delta = puzzle.evaluateMove(move);
+				if(((tabuUntil[move.originIndex] > iteration) || (tabuUntil[move.swapIndex] > iteration)) && (puzzle.getFitness() + delta >= bestFitness))
+					continue;
+
+				//Ties are broken uniformly at random (reservoir sampling), so the search doesn't keep favouring the same cells
+				if(delta < bestDelta)
+				{
+					bestDelta = delta;
+					bestMove = move;
+					numTies = 1;
+				}
+				else if((delta == bestDelta) && (random.nextInt(++numTies) == 0))
+					bestMove = move;
+			}
+		}
+
+		//Everything is tabu
+		if(bestDelta == INT_MAX)
+			break;
+
+		puzzle.applyMove(bestMove);
+		tabuUntil[bestMove.originIndex] = iteration + tabuTenure;
+		tabuUntil[bestMove.swapIndex] = iteration + tabuTenure;
+		rememberIfBest(puzzle);
+	}
+
+	if(puzzle.getFitness() > bestFitness)
+		puzzle.loadBoard(bestBoard.data(), bestFitness, bestHash);
+}
+
+//Simulated annealing: a swap that adds delta conflicts is kept with probability e^(-delta / temperature)
+void LocalSearch::simulatedAnnealing(SudokuPuzzle &puzzle, int iterations, RandomGenerator &random)
+{
+	PuzzleDefinitionPtr definition;
+	SwapMove move;
+	double temperature;
+	double cooling;
+	int originIndex;
+	int delta;
+
+	definition = puzzle.getDefinition();
+	temperature = initialTemperature;
+	cooling = pow(finalTemperature / initialTemperature, 1.0 / iterations);
+	bestFitness = INT_MAX;
+	rememberIfBest(puzzle);
+
+	for(int iteration = 0; (iteration < iterations) && (puzzle.getFitness() > 0); iteration++, temperature *= cooling)
+	{
+		const std::vector<int> &conflicted = puzzle.getConflictedCells();
+		if(conflicted.empty())
+			break;
+
+		originIndex = conflicted[random.nextInt(conflicted.size())];
+		const std::vector<int> &freeCells = definition->getFreeCells(definition->getBlock(originIndex));
+		move = puzzle.getCellSwapMove(originIndex, freeCells[random.nextInt(freeCells.size())]);
+		if(move.originIndex < 0)
+			continue;
+
+		delta = puzzle.evaluateMove(move);
+		if((delta <= 0) || (random.nextDouble() < exp(-delta / temperature)))
+		{
+			puzzle.applyMove(move);
+			rememberIfBest(puzzle);
+		}
+	}
+
+	if(puzzle.getFitness() > bestFitness)
+		puzzle.loadBoard(bestBoard.data(), bestFitness, bestHash);
+}
\ No newline at end of file
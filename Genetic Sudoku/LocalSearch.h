@@ -0,0 +1,44 @@
+#pragma once
+
+#include <limits.h>
+#include <math.h>
+#include <vector>
+#include "RandomGenerator.h"
+#include "SudokuPuzzle.h"
+
+//How many iterations a swap stays tabu for, in tabuSearch
+#define tabuTenure 4
+//Temperature schedule for simulatedAnnealing, cooled geometrically from the first to the second over the iterations
+#define initialTemperature 2.0
+#define finalTemperature 0.1
+
+//Which local search the post-mate mutation uses (see GeneticPopulation::spawnChildren)
+enum LocalSearchOperator
+{
+	exhaustiveLocalSearch,			//The original scans over every swap of every macroBlock
+	tabuLocalSearch,
+	annealingLocalSearch,
+	mixedLocalSearch				//Any of the above, picked at random per child
+};
+
+//Local search operators that improve a single SudokuPuzzle in place
+//	Both only ever move cells that are part of a conflict, swapping them with another free cell of their macroBlock, which is a
+//	small fraction of the swaps an exhaustive scan scores. The best board either of them comes across is the one that's kept.
+//	One of these is owned by each of a GeneticPopulation's breeders, so its buffers are reused from child to child
+class LocalSearch
+{
+private:
+	std::vector<int> conflictedCells;	//Snapshot of the puzzle's conflicted cells for the current tabuSearch iteration
+	std::vector<int> tabuUntil;			//For each board index, the iteration its cell can be moved again
+	std::vector<Cell> bestBoard;		//Best board seen during the current search
+	int bestFitness;
+	unsigned long long bestHash;
+
+	void rememberIfBest(SudokuPuzzle &);
+public:
+	LocalSearch();
+	LocalSearch(int);					//Sizes the buffers for boards of some size up front, so a search never allocates
+
+	void tabuSearch(SudokuPuzzle &, int, RandomGenerator &);			//Each iteration makes the best non-tabu swap of a conflicted cell, even if it makes things worse
+	void simulatedAnnealing(SudokuPuzzle &, int, RandomGenerator &);	//Each iteration tries a random swap of a conflicted cell, keeping worse ones with a chance that drops as it cools
+};
\ No newline at end of file
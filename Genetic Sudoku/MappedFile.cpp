@@ -0,0 +1,98 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//An empty file is opened just fine, it just doesn't get mapped (neither platform can map zero bytes)
+MappedFile::MappedFile(const char *fileName)
+{
+	contents = NULL;
+	length = 0;
+	opened = false;
+
+#if defined(_WIN32)
+	LARGE_INTEGER fileSize;
+
+	mappingHandle = NULL;
+	fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE)
+		return;
+	if(!GetFileSizeEx(fileHandle, &fileSize))
+		return;
+
+	length = (size_t) fileSize.QuadPart;
+	if(length > 0)
+	{
+		mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(mappingHandle == NULL)
+			return;
+		contents = (const char *) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if(contents == NULL)
+			return;
+	}
+#else
+	struct stat fileStatus;
+	void *mapping;
+
+	fileDescriptor = open(fileName, O_RDONLY);
+	if(fileDescriptor < 0)
+		return;
+	if((fstat(fileDescriptor, &fileStatus) != 0) || !S_ISREG(fileStatus.st_mode))
+		return;
+
+	length = (size_t) fileStatus.st_size;
+	if(length > 0)
+	{
+		mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if(mapping == MAP_FAILED)
+			return;
+		contents = (const char *) mapping;
+		madvise(mapping, length, MADV_SEQUENTIAL);	//It's parsed front to back exactly once
+	}
+#endif
+
+	opened = true;
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(_WIN32)
+	if(contents != NULL)
+		UnmapViewOfFile(contents);
+	if(mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+	if(fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+#else
+	if(contents != NULL)
+		munmap((void *) contents, length);
+	if(fileDescriptor >= 0)
+		close(fileDescriptor);
+#endif
+}
+
+bool MappedFile::isOpen() const
+{
+	return opened;
+}
+
+const char *MappedFile::begin() const
+{
+	return contents;
+}
+
+const char *MappedFile::end() const
+{
+	return contents + size();
+}
+
+size_t MappedFile::size() const
+{
+	return (contents != NULL) ? length : 0;
+}
\ No newline at end of file
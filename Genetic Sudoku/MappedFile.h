@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+
+//A whole file mapped read-only into memory, so it can be parsed in place without being read (or copied) into buffers
+//	The mapping lives as long as the MappedFile does
+class MappedFile
+{
+private:
+	const char *contents;				//Start of the mapping, NULL for an empty (or unopened) file
+	size_t length;
+#if defined(_WIN32)
+	void *fileHandle;					//Both of these are HANDLEs, kept as void * so windows.h stays out of the header
+	void *mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+	bool opened;
+
+	MappedFile(const MappedFile &);		//Not copyable, the mapping can only be unmapped once
+	MappedFile &operator=(const MappedFile &);
+public:
+	MappedFile(const char *);			//Maps some file, check isOpen() afterwards
+	~MappedFile();
+
+	bool isOpen() const;				//False if the file couldn't be opened or mapped
+	const char *begin() const;
+	const char *end() const;
+	size_t size() const;
+};
\ No newline at end of file
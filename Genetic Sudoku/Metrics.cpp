@@ -0,0 +1,144 @@
+#include "Metrics.h"
+
+//Names of the counters within an OperatorCounters, in order
+static const char *counterNames[] = { "invocations", "evaluations", "accepted", "fitness_gain", "fitness_loss", "nanoseconds" };
+#define countersPerOperator 6
+
+//Names of the phases, indexed by MetricPhase
+static const char *phaseNames[] = { "spawn", "improve", "migration" };
+
+void clearMetrics(IslandMetrics &metrics)
+{
+	memset(&metrics, 0, sizeof(metrics));
+}
+
+void addMetrics(IslandMetrics &totals, const IslandMetrics &metrics)
+{
+	long long *totalCounters = reinterpret_cast<long long *>(&totals);
+	const long long *counters = reinterpret_cast<const long long *>(&metrics);
+
+	for(int i = 0; i < countersPerIsland; i++)
+		totalCounters[i] += counters[i];
+}
+
+void countFitnessChange(OperatorCounters &counters, int before, int after)
+{
+	if(after < before)
+		counters.fitnessGain += before - after;
+	else
+		counters.fitnessLoss += after - before;
+}
+
+long long elapsedNanoseconds(std::chrono::high_resolution_clock::time_point startTime)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+MetricsRegistry::MetricsRegistry(int islands) : numIslands(islands), published(new std::atomic<long long>[islands * countersPerIsland])
+{
+	exporting = false;
+	for(int i = 0; i < numIslands * countersPerIsland; i++)
+		published[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::publish(int islandID, const IslandMetrics &metrics)
+{
+	const long long *counters = reinterpret_cast<const long long *>(&metrics);
+
+	for(int i = 0; i < countersPerIsland; i++)
+		published[islandID * countersPerIsland + i].store(counters[i], std::memory_order_relaxed);
+}
+
+void MetricsRegistry::collect(IslandMetrics &totals)
+{
+	long long *counters = reinterpret_cast<long long *>(&totals);
+
+	clearMetrics(totals);
+	for(int island = 0; island < numIslands; island++)
+		for(int i = 0; i < countersPerIsland; i++)
+			counters[i] += published[island * countersPerIsland + i].load(std::memory_order_relaxed);
+}
+
+//Whoever gets here first writes the file, anyone arriving in the meantime has newer numbers for the next export anyway
+bool MetricsRegistry::exportTo(const std::string &fileName, MetricsFormat format, int migrationRound)
+{
+	std::ostringstream text;
+	IslandMetrics totals;
+	bool written;
+
+	if(exporting.exchange(true))
+		return false;
+
+	collect(totals);
+	if(format == prometheusMetrics)
+		writeMetricsPrometheus(text, totals, migrationRound);
+	else
+		writeMetricsJson(text, totals, migrationRound);
+	written = replaceFile(fileName.c_str(), text.str());
+
+	exporting = false;
+	return written;
+}
+
+static void writeCountersJson(std::ostream &output, const OperatorCounters &counters)
+{
+	const long long *values = &counters.invocations;
+
+	output << "{";
+	for(int i = 0; i < countersPerOperator; i++)
+		output << (i ? ", " : "") << "\"" << counterNames[i] << "\": " << values[i];
+	output << "}";
+}
+
+//{"migration_round": n, "parent_configurations": [{...}, ...], "post_mate_mutations": [...], "phases": {"spawn": {...}, ...}}
+void writeMetricsJson(std::ostream &output, const IslandMetrics &metrics, int migrationRound)
+{
+	output << "{" << std::endl << "  \"migration_round\": " << migrationRound << "," << std::endl;
+
+	output << "  \"parent_configurations\": [" << std::endl;
+	for(int i = 0; i < numParentConfigurations; i++)
+	{
+		output << "    ";
+		writeCountersJson(output, metrics.parentConfigurations[i]);
+		output << ((i + 1 < numParentConfigurations) ? "," : "") << std::endl;
+	}
+	output << "  ]," << std::endl;
+
+	output << "  \"post_mate_mutations\": [" << std::endl;
+	for(int i = 0; i < numPostMateMutations; i++)
+	{
+		output << "    ";
+		writeCountersJson(output, metrics.postMateMutations[i]);
+		output << ((i + 1 < numPostMateMutations) ? "," : "") << std::endl;
+	}
+	output << "  ]," << std::endl;
+
+	output << "  \"phases\": {" << std::endl;
+	for(int i = 0; i < numPhases; i++)
+	{
+		output << "    \"" << phaseNames[i] << "\": ";
+		writeCountersJson(output, metrics.phases[i]);
+		output << ((i + 1 < numPhases) ? "," : "") << std::endl;
+	}
+	output << "  }" << std::endl << "}" << std::endl;
+}
+
+//One metric family per counter, e.g. sudoku_operator_evaluations_total{kind="post_mate_mutation",operator="3"} 1234
+void writeMetricsPrometheus(std::ostream &output, const IslandMetrics &metrics, int migrationRound)
+{
+	output << "# TYPE sudoku_migration_round gauge" << std::endl;
+	output << "sudoku_migration_round " << migrationRound << std::endl;
+
+	for(int counter = 0; counter < countersPerOperator; counter++)
+	{
+		output << "# TYPE sudoku_operator_" << counterNames[counter] << "_total counter" << std::endl;
+		for(int i = 0; i < numParentConfigurations; i++)
+			output << "sudoku_operator_" << counterNames[counter] << "_total{kind=\"parent_configuration\",operator=\"" << i << "\"} " << (&metrics.parentConfigurations[i].invocations)[counter] << std::endl;
+		for(int i = 0; i < numPostMateMutations; i++)
+			output << "sudoku_operator_" << counterNames[counter] << "_total{kind=\"post_mate_mutation\",operator=\"" << i << "\"} " << (&metrics.postMateMutations[i].invocations)[counter] << std::endl;
+
+		output << "# TYPE sudoku_phase_" << counterNames[counter] << "_total counter" << std::endl;
+		for(int i = 0; i < numPhases; i++)
+			output << "sudoku_phase_" << counterNames[counter] << "_total{phase=\"" << phaseNames[i] << "\"} " << (&metrics.phases[i].invocations)[counter] << std::endl;
+	}
+}
\ No newline at end of file
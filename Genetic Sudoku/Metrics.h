@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "BinaryFormat.h"
+
+//Operators in spawnChildren that get their own counters
+#define numParentConfigurations 8		//Ways the parents are picked (the pre-mate mutation is counted along with them)
+#define numPostMateMutations 16			//Cases of the post-mate mutation, the last one counts the children that didn't get one
+
+//Parts of an island's epoch that get their own counters
+enum MetricPhase
+{
+	spawnPhase,							//spawnChildren, breeding a whole generation
+	improvePhase,						//improveGenePool, children replacing members
+	migrationPhase,						//Sending and taking in migrants
+	numPhases
+};
+
+enum MetricsFormat
+{
+	jsonMetrics,
+	prometheusMetrics
+};
+
+//What an operator (or phase) has done so far
+struct OperatorCounters
+{
+	long long invocations;
+	long long evaluations;				//Fitness evaluations, full or of a single swap
+	long long accepted;					//Children it worked on that made it into the genePool
+	long long fitnessGain;				//Total amount it lowered the fitness of the boards it made better
+	long long fitnessLoss;				//Total amount it raised the fitness of the boards it made worse, kept apart so both only ever grow
+	long long nanoseconds;
+};
+
+//Every counter of one island
+//	Only the task running the island ever touches it, so the counters are plain numbers and cost next to nothing to bump
+//	Nothing but long longs go in here, MetricsRegistry treats it as an array of them
+struct IslandMetrics
+{
+	OperatorCounters parentConfigurations[numParentConfigurations];
+	OperatorCounters postMateMutations[numPostMateMutations];
+	OperatorCounters phases[numPhases];
+};
+
+#define countersPerIsland ((int) (sizeof(IslandMetrics) / sizeof(long long)))
+
+void clearMetrics(IslandMetrics &);
+void addMetrics(IslandMetrics &, const IslandMetrics &);	//Adds the second's counters onto the first's
+void countFitnessChange(OperatorCounters &, int, int);	//Adds a board going from the first fitness to the second onto the gain or the loss
+long long elapsedNanoseconds(std::chrono::high_resolution_clock::time_point);	//Since some point in time, for filling in the nanoseconds counters
+
+//Where the islands' counters are gathered up, without any locks
+//	An island publishes a copy of its counters at the end of every epoch (relaxed atomic stores, which are plain stores on x86),
+//	and exporting reads them back with relaxed loads. Every counter only ever grows, so totals that mix counters published
+//	at slightly different times are still a consistent snapshot of some recent moment
+//	(which is why fitness changes are split into a gain and a loss rather than kept as one signed total)
+class MetricsRegistry
+{
+private:
+	int numIslands;
+	std::unique_ptr<std::atomic<long long>[]> published;	//countersPerIsland for each island
+	std::atomic<bool> exporting;		//Set while the metrics are being written out, anyone else who wants to export skips it
+public:
+	MetricsRegistry(int);				//Number of islands
+
+	void publish(int, const IslandMetrics &);	//Replaces what an island last published
+	void collect(IslandMetrics &);		//Totals over every island
+	bool exportTo(const std::string &, MetricsFormat, int);	//Writes the totals (and the migration round) to a file, false if someone else was already exporting or it couldn't be written
+};
+
+void writeMetricsJson(std::ostream &, const IslandMetrics &, int);			//Totals and the migration round they're from
+void writeMetricsPrometheus(std::ostream &, const IslandMetrics &, int);	//Same, in the Prometheus text exposition format
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "MigrationQueue.h"
+
+MigrationQueue::MigrationQueue(int capacity)
+{
+	slots.resize(capacity);
+	head = 0;
+	tail = 0;
+}
+
+bool MigrationQueue::push(const SudokuPuzzle &migrant)
+{
+	size_t currentTail;
+
+	currentTail = tail.load(std::memory_order_relaxed);
+	if(currentTail - head.load(std::memory_order_acquire) == slots.size())
+		return false;
+
+	slots[currentTail % slots.size()] = migrant;
+	tail.store(currentTail + 1, std::memory_order_release);	//Publishes the slot to the consumer
+
+	return true;
+}
+
+bool MigrationQueue::pop(SudokuPuzzle &migrant)
+{
+	size_t currentHead;
+
+	currentHead = head.load(std::memory_order_relaxed);
+	if(currentHead == tail.load(std::memory_order_acquire))
+		return false;
+
+	migrant = slots[currentHead % slots.size()];
+	head.store(currentHead + 1, std::memory_order_release);	//Hands the slot back to the producer
+
+	return true;
+}
+
+std::vector<std::vector<int>> buildMigrationTopology(MigrationTopology topology, int numIslands)
+{
+	std::vector<std::vector<int>> neighbours(numIslands);
+	int width;
+	int height;
+	int candidates[2];
+
+	//The grid is made as square as possible, a prime number of islands ends up as a single column (a ring)
+	width = (int) sqrt((double) numIslands);
+	while(numIslands % width != 0)
+		width--;
+	height = numIslands / width;
+
+	for(int i = 0; i < numIslands; i++)
+	{
+		switch(topology)
+		{
+		case ringTopology:
+			if(numIslands > 1)
+				neighbours[i].push_back((i + 1) % numIslands);
+			break;
+		case torusTopology:
+			candidates[0] = (i / width) * width + (i % width + 1) % width;	//Right
+			candidates[1] = ((i / width + 1) % height) * width + i % width;		//Down
+			for(int j = 0; j < 2; j++)
+				if((candidates[j] != i) && (std::find(neighbours[i].begin(), neighbours[i].end(), candidates[j]) == neighbours[i].end()))
+					neighbours[i].push_back(candidates[j]);
+			break;
+		case fullyConnectedTopology:
+			for(int j = 0; j < numIslands; j++)
+				if(j != i)
+					neighbours[i].push_back(j);
+			break;
+		}
+	}
+
+	return neighbours;
+}
\ No newline at end of file
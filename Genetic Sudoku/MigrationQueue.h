@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <vector>
+#include "SudokuPuzzle.h"
+
+//Lock-free single-producer/single-consumer ring buffer of migrants between two islands
+//	Exactly one thread may push and exactly one (other) thread may pop. Neither ever waits: a full queue drops the migrant
+//	(there'll be fresher ones next round), and an empty queue just means there's nothing to take in yet
+class MigrationQueue
+{
+private:
+	std::vector<SudokuPuzzle> slots;	//Ring storage, slots are copy-assigned into so they stop allocating once warmed up
+	std::atomic<size_t> head;			//Next slot to pop, only written by the consumer
+	char padding[64];					//Keeps head and tail on separate cache lines so the two threads don't fight over them
+	std::atomic<size_t> tail;			//Next slot to push, only written by the producer
+public:
+	MigrationQueue(int);				//Creates a queue that can hold some number of migrants
+
+	bool push(const SudokuPuzzle &);	//Producer side, false if the queue was full
+	bool pop(SudokuPuzzle &);			//Consumer side, false if the queue was empty
+};
+
+//Which islands send migrants to which
+enum MigrationTopology
+{
+	ringTopology,				//Island i sends to island i + 1
+	torusTopology,				//Islands are laid out on a wrapping grid, each sends to its right and lower neighbours
+	fullyConnectedTopology		//Every island sends to every other island
+};
+
+std::vector<std::vector<int>> buildMigrationTopology(MigrationTopology, int);	//For each of some number of islands, the islands it sends migrants to
\ No newline at end of file
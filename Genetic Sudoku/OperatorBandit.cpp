@@ -0,0 +1,86 @@
+#include "OperatorBandit.h"
+
+//This lets you call OperatorBandit x;
+OperatorBandit::OperatorBandit()
+{
+	totalPlays = 0;
+}
+
+OperatorBandit::OperatorBandit(int numArms)
+{
+	estimates.assign(numArms, 0);
+	plays.assign(numArms, 0);
+	rewards.assign(numArms, 0);
+	totalPlays = 0;
+}
+
+//Arms that have only ever earned nothing have an estimate of 0, and are left to the exploration term
+//	A play is counted as soon as its arm is picked, rewards can come in much later (a whole generation of children is bred
+//	before any of them are credited), and the picks made in the meantime still have to spread out over the arms
+int OperatorBandit::select()
+{
+	double bestEstimate;
+	double bestScore;
+	double score;
+	int bestArm;
+
+	bestEstimate = 0;
+	for(int arm = 0; arm < estimates.size(); arm++)
+	{
+		if(plays[arm] == 0)
+		{
+			plays[arm]++;
+			totalPlays++;
+			return arm;
+		}
+		bestEstimate = std::max(bestEstimate, estimates[arm]);
+	}
+	if(bestEstimate <= 0)
+		bestEstimate = 1;
+
+	bestArm = 0;
+	bestScore = -1;
+	for(int arm = 0; arm < estimates.size(); arm++)
+	{
+		score = estimates[arm] / bestEstimate + banditExploration * sqrt(2 * log(totalPlays) / plays[arm]);
+		if(score > bestScore)
+		{
+			bestScore = score;
+			bestArm = arm;
+		}
+	}
+	plays[bestArm]++;
+	totalPlays++;
+
+	return bestArm;
+}
+
+//A plain running average for the first few plays, then an exponentially weighted one
+void OperatorBandit::update(int arm, double reward)
+{
+	rewards[arm]++;
+	estimates[arm] += (reward - estimates[arm]) * std::max(1 / rewards[arm], banditAdaptationRate);
+}
+
+int OperatorBandit::getNumArms()
+{
+	return (int) estimates.size();
+}
+
+void OperatorBandit::saveState(std::vector<double> &state)
+{
+	state.insert(state.end(), estimates.begin(), estimates.end());
+	state.insert(state.end(), plays.begin(), plays.end());
+	state.insert(state.end(), rewards.begin(), rewards.end());
+}
+
+void OperatorBandit::loadState(const double *state)
+{
+	estimates.assign(state, state + estimates.size());
+	plays.assign(state + estimates.size(), state + 2 * estimates.size());
+	rewards.assign(state + 2 * estimates.size(), state + 3 * estimates.size());
+
+	totalPlays = 0;
+	for(int arm = 0; arm < plays.size(); arm++)
+		totalPlays += plays[arm];
+}
\ No newline at end of file
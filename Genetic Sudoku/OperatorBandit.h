@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+//Once an arm has been played this many times, each new reward moves its estimate by a fixed fraction, so the estimates keep up
+//	with the run (what pays off early on is rarely what pays off near the end)
+#define banditAdaptationRate 0.05
+//Weight of the exploration term, against rewards normalized so the best arm's estimate is 1
+#define banditExploration 0.5
+
+//How spawnChildren picks its parent configuration and post-mate mutation
+enum OperatorSelection
+{
+	fixedOperators,					//The original fixed odds, with variance pushing towards random parents
+	adaptiveOperators				//An OperatorBandit per choice, learning which operators pay off
+};
+
+//Adaptive operator selection as a multi-armed bandit: UCB1 over recency-weighted average rewards
+//	Rewards can be in any units (fitness gained per evaluation, say), the estimates are divided by the best arm's before the
+//	exploration term is added, so how much exploring gets done doesn't depend on how big the rewards happen to be
+//	Picking an arm involves no randomness, so a population using these is just as reproducible as one that isn't
+class OperatorBandit
+{
+private:
+	std::vector<double> estimates;	//Recency-weighted average reward of each arm
+	std::vector<double> plays;		//Times each arm has been picked
+	std::vector<double> rewards;	//Rewards each arm has been given so far, which can lag behind its plays
+	double totalPlays;
+public:
+	OperatorBandit();				//Empty constructor so that empty objects can be created
+	OperatorBandit(int);			//Creates a bandit over some number of arms, none of which have been played
+
+	int select();					//Every arm once, in order, then whichever has the highest upper confidence bound (counts as a play)
+	void update(int, double);		//Records the reward one of an arm's plays earned
+	int getNumArms();
+	void saveState(std::vector<double> &);	//Appends the estimates and counts (3 doubles per arm), for a checkpoint
+	void loadState(const double *);	//Reads back what saveState appended
+};
\ No newline at end of file
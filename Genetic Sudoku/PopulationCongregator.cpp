@@ -1,145 +1,610 @@
 #include "PopulationCongregator.h"
+#include "BatchSolver.h"
+#include "Benchmark.h"
 
-//Starts a PopulationCoordinator based off of a SudokuPuzzle file
-void init(char *file)
+//Sets up a PopulationCongregator for a single puzzle, nothing runs until start is called
+PopulationCongregator::PopulationCongregator(PuzzleDefinitionPtr puzzle, const SolverConfig &solverConfig, TaskScheduler &taskScheduler) : scheduler(taskScheduler), metrics(solverConfig.numIslands)
 {
+	RandomGenerator random(solverConfig.seed);
+
+	config = solverConfig;
+	definition = puzzle;
 	optimalSolution = false;
-	fileName = file;
-	threadConfigs.reserve(numThreads);
-	
+	stopRequested = false;
+	budgetExpired = false;
+	evaluationsSpent = 0;
+	finished = false;
+	migrationRounds = 0;
+	lastImprovement = 0;
+	activeTasks = 0;
+	exactSolverStarted = false;
+	checkpointWriter = NULL;
+	checkpointRound = 0;
+	checkpointContributions = 0;
+	islandCheckpointRound.assign(config.numIslands, 0);
+	islandConfigs.reserve(config.numIslands);
+
 	//Sets up initial SudokuPuzzles used for population seeding
-	for(int i = 0; i < numThreads; i++)
-		threadConfigs.push_back(std::vector<SudokuPuzzle>());
+	for(int i = 0; i < config.numIslands; i++)
+		islandConfigs.push_back(std::vector<SudokuPuzzle>());
+
+	//Every SudokuPuzzle shares the one definition
+	for(int i = 0; i < std::max(config.populationSize, config.numIslands); i++)
+		islandConfigs[i % config.numIslands].push_back(SudokuPuzzle(definition, random));
 
-	for(int i = 0; i < populationSize; i++)
-		threadConfigs[i % numThreads].push_back(SudokuPuzzle(fileName));
+	assert(islandConfigs.size() == config.numIslands);
+	islands.resize(config.numIslands);
+	bestSpecimen = islandConfigs[0][0];
+	buildMigrationQueues();
+
+	//Constraint propagation can solve a puzzle outright, in which case every board is already the solution
+	if(bestSpecimen.getFitness() == 0)
+	{
+		theSolution = bestSpecimen;
+		optimalSolution = true;
+	}
+}
 
-	assert(threadConfigs.size() == numThreads);
-	spawnThreads();
+//Islands hold a pointer back to this, so they all have to be gone before it is
+PopulationCongregator::~PopulationCongregator()
+{
+	stop();
+	wait();
 }
 
-//Controls a specific GeneticPopulation
-void workerThread(int threadID)
+//Sets up a single-producer/single-consumer queue for every island -> neighbour edge
+void PopulationCongregator::buildMigrationQueues()
 {
-	//Run forever!
-	while(true)
+	std::vector<std::vector<int>> neighbours;
+	int queueCapacity;
+
+	neighbours = buildMigrationTopology(config.migrationTopology, config.numIslands);
+	queueCapacity = migrationQueueSlotsPerMigrant * config.numberOfMigrants;
+	outgoingQueues.resize(config.numIslands);
+	incomingQueues.resize(config.numIslands);
+
+	for(int i = 0; i < config.numIslands; i++)
 	{
-		//Create a new genetic population every generation (in reference to the PopulationCoordinator) based off of pre-existing SudokuPuzzles
-		GeneticPopulation smallPopulace(threadConfigs[threadID]);
-		std::vector<SudokuPuzzle> tempArray;
-		tempArray = smallPopulace.getPopulationSegment();
+		for(int j = 0; j < neighbours[i].size(); j++)
+		{
+			migrationQueues.push_back(std::unique_ptr<MigrationQueue>(new MigrationQueue(queueCapacity)));
+			outgoingQueues[i].push_back(migrationQueues.back().get());
+			incomingQueues[neighbours[i][j]].push_back(migrationQueues.back().get());
+		}
+	}
+}
+
+//The lock is only taken when an island actually improves on the best so far, which is rare
+void PopulationCongregator::reportBest(GeneticPopulation &island)
+{
+	SudokuPuzzle islandBest;
 
-		assert(tempArray.size() == (populationSize /2));
+	islandBest = island.getBest();
 
-		//Critical region:
-		//	unique_lock is used to simulate a barrier
-		//	This code locks threadMutex
-		std::unique_lock<std::mutex> lock(threadMutex);
+	std::lock_guard<std::mutex> lock(threadMutex);
+	if(islandBest.getFitness() < bestSpecimen.getFitness())
+	{
+		bestSpecimen = islandBest;
+		lastImprovement = migrationRounds.load();
 
-		//If the solution is found, update global variables
-		if(tempArray[0].getFitness() == 0)
+		//If the solution is found, every island stops before its next child
+		if(islandBest.getFitness() == 0)
 		{
+			theSolution = islandBest;
 			optimalSolution = true;
-			theSolution = tempArray[0];
 		}
+	}
+}
+
+//Advances a specific GeneticPopulation by one epoch (numberOfGenerations generations), then migrates
+//	The population (an "island") lives for the whole run, only migrants are exchanged between epochs.
+//	Rather than owning a thread, an island reschedules itself, so any number of islands can share the worker threads
+void PopulationCongregator::runIslandEpoch(int islandID)
+{
+	std::vector<SudokuPuzzle> migrants;
+	std::vector<SudokuPuzzle> immigrants;
+	SudokuPuzzle arrival;
+	int migrantsPerNeighbour;
+	int round;
+	std::chrono::high_resolution_clock::time_point migrationStart;
+
+	//Run until some island finds the solution, or the deadline or budget run out
+	//	Checked here as well as while breeding, so stopping doesn't depend on the island breeding at all (an optimal one doesn't)
+	if(shouldStop(0))
+	{
+		taskStopped();
+		return;
+	}
+
+	//The first epoch creates the island on whichever worker picked it up, so its memory is local to that worker
+	if(!islands[islandID])
+	{
+		if(!restoredIslands.empty())
+		{
+			islands[islandID].reset(new GeneticPopulation(restoredIslands[islandID], definition, config));
+			IslandState().boards.swap(restoredIslands[islandID].boards);	//Not needed anymore
+		}
+		else
+		{
+			RandomGenerator islandRandom(config.seed + islandID + 1);	//Each island gets its own stream, its population is seeded off of it
+			islands[islandID].reset(new GeneticPopulation(islandConfigs[islandID], config, islandRandom.next()));
+		}
+		islands[islandID]->setStopCondition(std::bind(&PopulationCongregator::shouldStop, this, std::placeholders::_1));
+		islands[islandID]->setScheduler(&scheduler);
+	}
+	GeneticPopulation &island = *islands[islandID];
+
+	//Each neighbour gets its own share of migrants (always including the best)
+	migrantsPerNeighbour = config.numberOfMigrants;
+	if(outgoingQueues[islandID].size() > 1)
+		migrantsPerNeighbour = std::max(1, config.numberOfMigrants / (int) outgoingQueues[islandID].size());
+
+	//An epoch cut short doesn't count as a round, and its island has nothing new to send or snapshot, but its best still counts
+	if(!island.advancePopulation())
+	{
+		reportBest(island);
+		metrics.publish(islandID, island.getMetrics());
+		taskStopped();
+		return;
+	}
+	round = ++migrationRounds;
+	reportBest(island);
 
-		//Update the global array of Specimens
-		for(int i = 0; i < tempArray.size(); i++)
-			overLordArray.push_back(tempArray[i]);
+	//A stalled search gets finished off by the exact solver, which runs alongside the islands (this island keeps it from finishing before it's counted in)
+	if((config.stagnationEpochs > 0) && (migrationRounds - lastImprovement >= config.stagnationEpochs * config.numIslands) && !exactSolverStarted.exchange(true))
+	{
+		activeTasks++;
+		scheduler.submit(std::bind(&PopulationCongregator::runExactSolver, this));
+	}
+
+	//Publish this island's migrants to its neighbours, a full queue just drops them
+	migrationStart = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < outgoingQueues[islandID].size(); i++)
+	{
+		migrants = island.getMigrants(migrantsPerNeighbour);
+		for(int j = 0; j < migrants.size(); j++)
+			outgoingQueues[islandID][i]->push(migrants[j]);
+	}
+
+	//Take in whatever has arrived since the last epoch, without waiting for anything
+	for(int i = 0; i < incomingQueues[islandID].size(); i++)
+		while(incomingQueues[islandID][i]->pop(arrival))
+			immigrants.push_back(arrival);
 
-		//Let the master thread know we're finished
-		finishedThreads++;
+	if(!immigrants.empty())
+		island.acceptMigrants(immigrants);
+	island.getMetrics().phases[migrationPhase].invocations++;
+	island.getMetrics().phases[migrationPhase].nanoseconds += elapsedNanoseconds(migrationStart);
 
-		condVar.wait(lock);	//Chill out here dog
+	//Once per full round (every island having had an epoch), on whichever island completes it
+	metrics.publish(islandID, island.getMetrics());
+	if(round % config.numIslands == 0)
+		exportMetrics();
+
+	//Between epochs is the only time an island's state is complete, and this island's task is the only one touching it
+	if(checkpointRound > islandCheckpointRound[islandID])
+	{
+		islandCheckpointRound[islandID] = checkpointRound;
+		contributeCheckpoint(islandID, island);
 	}
+
+	//Taking turns with the other islands on this worker
+	scheduler.submitDeferred(std::bind(&PopulationCongregator::runIslandEpoch, this, islandID));
 }
 
-//Empties the pools of SudokuPuzzles that will be sent to threads
-void clearThreadConfigs()
+//First tries to complete the best board so far, keeping every cell that doesn't conflict with anything
+//	That's usually only a few cells away from a solution, but the cells that were kept can be wrong, so if it doesn't pan out
+//	the puzzle is solved from just the givens. That always finishes, and if it finds nothing the puzzle has no solution
+void PopulationCongregator::runExactSolver()
 {
-	threadConfigs.clear();
-	for(int i = 0; i < numThreads; i++)
-		threadConfigs.push_back(std::vector<SudokuPuzzle>());
+	ExactSolver solver(definition);
+	std::function<bool()> shouldStop;
+	bool solved;
+
+	shouldStop = [this] { return this->shouldStop(0); };
+	solved = solver.solve(solver.keepConsistentCells(getBest().getBoard()), exactSeedNodeLimit, shouldStop);
+	if(!solved && !shouldStop())
+		solved = solver.solve(std::vector<Cell>(definition->getGivens()), -1, shouldStop);
+
+	if(solved)
+	{
+		std::lock_guard<std::mutex> lock(threadMutex);
+		if(!optimalSolution)
+		{
+			theSolution = SudokuPuzzle(definition, solver.getSolution().data());
+			bestSpecimen = theSolution;
+			optimalSolution = true;
+		}
+	}
+	else if(!solver.wasAborted())
+		stop();
+
+	taskStopped();
 }
 
-void spawnThreads()
+//Copying the genePool out is all an island does here, packing and writing the checkpoint happens on the checkpointWriter's thread
+void PopulationCongregator::contributeCheckpoint(int islandID, GeneticPopulation &island)
 {
-	finishedThreads = 0;
+	IslandState state;
 
-	for(int i = 0; i < numThreads; i++)
-		threadPool.push_back(std::thread(workerThread, i));
+	island.saveState(state);
+
+	std::lock_guard<std::mutex> lock(checkpointMutex);
+	pendingCheckpoint.islands[islandID] = state;
+	if(++checkpointContributions < config.numIslands)
+		return;
+
+	pendingCheckpoint.migrationRounds = migrationRounds;
+	pendingCheckpoint.lastImprovement = lastImprovement;
+	checkpointWriter->submit(pendingCheckpoint);
 }
 
-//Master thread:
-void run()
+//The clock is only read when there's a time limit, and the shared evaluation count only touched when there's an evaluation budget
+bool PopulationCongregator::shouldStop(long long evaluations)
 {
-	int generationCounter;
-	std::chrono::high_resolution_clock::time_point time;
+	if(optimalSolution || stopRequested)
+		return true;
+
+	if(((config.evaluationBudget > 0) && ((evaluationsSpent += evaluations) >= config.evaluationBudget)) ||
+		((config.timeLimit > 0) && (std::chrono::high_resolution_clock::now() >= deadline)))
+	{
+		budgetExpired = true;
+		stopRequested = true;
+		return true;
+	}
+
+	return false;
+}
 
-	time = std::chrono::high_resolution_clock::now();
-	generationCounter = 0;
+//The last task out wakes up whoever is waiting on the solve
+void PopulationCongregator::taskStopped()
+{
+	std::function<void()> callback;
 
-	while(true)
 	{
-		//Since we're only reading, we don't care about locking finishedThreads
-		while(finishedThreads != numThreads)
-			std::this_thread::sleep_for(std::chrono::milliseconds(2000));	//Wake up every two seconds to check if the workers are finished
-	
-		//Only reaches here when all worker threads are waiting at the barrier
+		std::lock_guard<std::mutex> lock(threadMutex);
+		if(--activeTasks > 0)
+			return;
 
-		//Information print outs, can be abstracted to methods...
-		std::cout << "Generation: " << ++generationCounter << std::endl;
-		clearThreadConfigs();
+		endTime = std::chrono::high_resolution_clock::now();
+		callback = onFinished;
+		finished = true;
+		condVar.notify_all();
+	}
 
-		//Evenly distribute the gathered SudokuPuzzles among the threads, this mixes the populations
-		for(int i = 0; i < overLordArray.size(); i++)
-			threadConfigs[i % numThreads].push_back(overLordArray[i]);
+	//The callback is allowed to destroy this PopulationCongregator, so nothing of it can be touched from here on
+	if(callback)
+		callback();
+}
 
-		//Check to see if an optimal solution has been found (this is redundant)
-		std::sort(overLordArray.begin(), overLordArray.end());
-		std::cout << "Current best fitness: " << overLordArray[0].getFitness() << std::endl;
-		
-		//Print the best board every ten generations
-		if(generationCounter % 10 == 0)
-			overLordArray[0].printBoard();
+//The checkpoint has to have been taken with the settings this PopulationCongregator was created with (see loadCheckpointSettings)
+void PopulationCongregator::restore(const Checkpoint &checkpoint)
+{
+	int bestIsland;
+	int bestSlot;
 
-		overLordArray.clear();
-		finishedThreads = 0;
+	assert(checkpoint.islands.size() == config.numIslands);
+	restoredIslands = checkpoint.islands;
+	migrationRounds = checkpoint.migrationRounds;
+	lastImprovement = checkpoint.lastImprovement;
 
-		//If no optimal solution has been found, continue to populate/breed
-		if(!optimalSolution)
-			condVar.notify_all();
-		else
-			break;
+	//The islands aren't created until their first task runs, so the best so far is picked out of the saved boards
+	//	They're rescored first, the same as the islands will do, rather than going by the fitnesses the file claims
+	bestIsland = 0;
+	bestSlot = 0;
+	for(int i = 0; i < restoredIslands.size(); i++)
+	{
+		for(int j = 0; j < restoredIslands[i].fitness.size(); j++)
+			restoredIslands[i].fitness[j] = definition->scoreBoard(&restoredIslands[i].boards[j * definition->getSizeOfBoard() * definition->getSizeOfBoard()]);
+		for(int j = 0; j < restoredIslands[i].fitness.size(); j++)
+		{
+			if(restoredIslands[i].fitness[j] < restoredIslands[bestIsland].fitness[bestSlot])
+			{
+				bestIsland = i;
+				bestSlot = j;
+			}
+		}
+	}
+
+	bestSpecimen = SudokuPuzzle(definition, &restoredIslands[bestIsland].boards[bestSlot * definition->getSizeOfBoard() * definition->getSizeOfBoard()]);
+	if(bestSpecimen.getFitness() == 0)
+	{
+		theSolution = bestSpecimen;
+		optimalSolution = true;
+	}
+}
+
+void PopulationCongregator::setCheckpointWriter(CheckpointWriter *writer)
+{
+	checkpointWriter = writer;
+}
+
+//Each island snapshots itself at the end of its current epoch, so nobody waits on anybody
+//	If the last checkpoint hasn't been collected yet (an island that's far behind), this one is skipped rather than stacked up
+bool PopulationCongregator::requestCheckpoint()
+{
+	std::lock_guard<std::mutex> lock(checkpointMutex);
+
+	if((checkpointWriter == NULL) || ((checkpointRound > 0) && (checkpointContributions < config.numIslands)))
+		return false;
+
+	pendingCheckpoint.sizeOfBoard = definition->getSizeOfBoard();
+	pendingCheckpoint.givens = definition->getGivens();
+	saveCheckpointSettings(config, pendingCheckpoint);
+	pendingCheckpoint.islands.resize(config.numIslands);
+	checkpointContributions = 0;
+	checkpointRound++;
+
+	return true;
+}
+
+void PopulationCongregator::start(std::function<void()> finishedCallback)
+{
+	onFinished = finishedCallback;
+	startTime = std::chrono::high_resolution_clock::now();
+	deadline = startTime + std::chrono::milliseconds(config.timeLimit);
+	activeTasks = config.numIslands;
+
+	for(int i = 0; i < config.numIslands; i++)
+		scheduler.submit(std::bind(&PopulationCongregator::runIslandEpoch, this, i));
+}
+
+void PopulationCongregator::stop()
+{
+	stopRequested = true;
+}
+
+bool PopulationCongregator::waitFor(int milliseconds)
+{
+	std::unique_lock<std::mutex> lock(threadMutex);
+
+	return condVar.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return (activeTasks.load() == 0); });
+}
+
+void PopulationCongregator::wait()
+{
+	std::unique_lock<std::mutex> lock(threadMutex);
+
+	condVar.wait(lock, [this] { return (activeTasks.load() == 0); });
+}
+
+bool PopulationCongregator::isFinished()
+{
+	return finished;
+}
+
+bool PopulationCongregator::isSolved()
+{
+	return optimalSolution;
+}
+
+bool PopulationCongregator::isBudgetExpired()
+{
+	return budgetExpired;
+}
+
+int PopulationCongregator::getGenerations()
+{
+	return migrationRounds / config.numIslands;
+}
+
+bool PopulationCongregator::exportMetrics()
+{
+	if(config.metricsPath.empty())
+		return false;
+
+	return metrics.exportTo(config.metricsPath, config.metricsFormat, migrationRounds / config.numIslands);
+}
+
+//Islands that never got to run (the puzzle was already solved) don't count
+long long PopulationCongregator::getTotalGenerations()
+{
+	long long total;
+
+	total = 0;
+	for(int i = 0; i < islands.size(); i++)
+		if(islands[i])
+			total += islands[i]->getGenerations();
+
+	return total;
+}
+
+long long PopulationCongregator::getTotalEvaluations()
+{
+	long long total;
+
+	total = 0;
+	for(int i = 0; i < islands.size(); i++)
+		if(islands[i])
+			total += islands[i]->countEvaluations();
+
+	return total;
+}
+
+long long PopulationCongregator::getElapsedMilliseconds()
+{
+	std::lock_guard<std::mutex> lock(threadMutex);
+
+	if(finished)
+		return std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+SudokuPuzzle PopulationCongregator::getBest()
+{
+	std::lock_guard<std::mutex> lock(threadMutex);
+
+	return bestSpecimen;
+}
+
+SudokuPuzzle PopulationCongregator::getSolution()
+{
+	std::lock_guard<std::mutex> lock(threadMutex);
+
+	return theSolution;
+}
+
+//Solves a single puzzle, reporting progress every couple of seconds until it's done
+//	The run can be checkpointed as it goes, and picked back up from a checkpoint instead of starting from the puzzle file
+int solveSingle(const SolverConfig &solverConfig)
+{
+	int reportCounter;
+	SolverConfig config;
+	TaskScheduler scheduler(solverConfig.numThreads, solverConfig.pinThreads);
+	std::vector<int> initialBoard;
+	Checkpoint checkpoint;
+	std::unique_ptr<CheckpointWriter> checkpointWriter;
+	std::chrono::high_resolution_clock::time_point lastCheckpoint;
+
+	config = solverConfig;
+
+	//The file is only parsed once, every SudokuPuzzle shares the resulting definition
+	if(!config.resumePath.empty())
+	{
+		if(!readCheckpoint(config.resumePath.c_str(), checkpoint))
+		{
+			std::cerr << "Could not read checkpoint: " << config.resumePath << std::endl;
+			return 1;
+		}
+		if(!checkpoint.islands.empty())
+			loadCheckpointSettings(checkpoint, config);
+		initialBoard.assign(checkpoint.givens.begin(), checkpoint.givens.end());
+	}
+	else
+		initialBoard = parseFile(config.fileName.c_str());
+	if(!PuzzleDefinition::isValidShape(initialBoard))
+	{
+		std::cerr << "Not a valid Sudoku Puzzle: " << (config.resumePath.empty() ? config.fileName : config.resumePath) << std::endl;
+		return 1;
+	}
+
+	//Declared before the congregator, so the islands are gone before the writer is
+	if(!config.checkpointPath.empty())
+		checkpointWriter.reset(new CheckpointWriter(config.checkpointPath));
+
+	PuzzleDefinitionPtr definition = std::make_shared<PuzzleDefinition>(initialBoard);
+	PopulationCongregator congregator(definition, config, scheduler);
+
+	std::cout << "Constraint propagation fixed " << definition->getNumForcedCells() << " cells" << std::endl;
+	if(!checkpoint.islands.empty())
+	{
+		congregator.restore(checkpoint);
+		std::cout << "Resuming from generation " << congregator.getGenerations() << " (seed " << config.seed << ")" << std::endl;
+	}
+	congregator.setCheckpointWriter(checkpointWriter.get());
+
+	std::cout<< "Starting " << config.numIslands << " islands on " << config.numThreads << " threads... " << std::endl;
+	congregator.start();
+	reportCounter = 0;
+	lastCheckpoint = std::chrono::high_resolution_clock::now();
+
+	//Wakes up every two seconds to print progress, or as soon as a solution is found
+	while(!congregator.waitFor(2000))
+	{
+		//Information print outs, can be abstracted to methods...
+		std::cout << "Generation: " << congregator.getGenerations() << std::endl;
+		std::cout << "Current best fitness: " << congregator.getBest().getFitness() << std::endl;
+
+		//Print the best board every ten reports
+		if(++reportCounter % 10 == 0)
+			congregator.getBest().printBoard();
+
+		if(checkpointWriter && (std::chrono::high_resolution_clock::now() - lastCheckpoint >= std::chrono::seconds(config.checkpointInterval)))
+		{
+			if(congregator.requestCheckpoint())
+				lastCheckpoint = std::chrono::high_resolution_clock::now();
+		}
 	}
 
 	//Final config outputs
-	std::chrono::high_resolution_clock::time_point time2 = std::chrono::high_resolution_clock::now();
-	std::cout << "Operation took: " << std::chrono::duration_cast<std::chrono::milliseconds>(time2 - time).count() << std::endl;
+	congregator.exportMetrics();
+	std::cout << "Operation took: " << congregator.getElapsedMilliseconds() << std::endl;
+	if(congregator.isBudgetExpired() && !congregator.isSolved())
+	{
+		std::cout << "Ran out of budget, best fitness: " << congregator.getBest().getFitness() << std::endl;
+		congregator.getBest().printBoard();
+		return 2;
+	}
+	if(!congregator.isSolved())
+	{
+		std::cout << "The puzzle has no solution, best fitness: " << congregator.getBest().getFitness() << std::endl;
+		return 1;
+	}
+	congregator.getSolution().printBoard();
+
+	return 0;
 }
 
-//Seeds random
-void initRandomSeed()
+//Writes the puzzle (or every puzzle of the batch) out as a binary puzzle file
+int convertPuzzles(const SolverConfig &config)
 {
-	srand((unsigned)time(0));
+	std::vector<std::vector<int>> puzzles;
+	const char *source;
+
+	source = config.batchPath.empty() ? config.fileName.c_str() : config.batchPath.c_str();
+	if(!parsePuzzleFile(source, puzzles))
+	{
+		std::cerr << "Could not read file: " << source << std::endl;
+		return 1;
+	}
+	for(int i = 0; i < puzzles.size(); i++)
+	{
+		if(!PuzzleDefinition::isValidShape(puzzles[i]))
+		{
+			std::cerr << "Not a valid Sudoku Puzzle: " << source << " #" << i + 1 << std::endl;
+			return 1;
+		}
+	}
+	if(!writePuzzles(config.convertPath.c_str(), puzzles))
+	{
+		std::cerr << "Could not write " << config.convertPath << " (the puzzles all have to be the same size)" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Wrote " << puzzles.size() << " puzzles to " << config.convertPath << std::endl;
+	return 0;
 }
 
 int main(int argc, char **argv)
 {
-	initRandomSeed();
+	SolverConfig config;
+	int result;
 
-	//Checks for command-line parameters, tries to execute with "sudoku1.csv" if none are found
-	if(argc < 2)
-		init("sudoku1.csv");
-	else
-		init(argv[1]);
+	//Tries to execute with "sudoku1.csv" if no puzzle file is given, an explicit seed reproduces a run
+	config = getDefaultConfig();
+	if(!parseCommandLine(argc, argv, config))
+	{
+		printUsage();
+		return 1;
+	}
+	std::cout << "Seed: " << config.seed << std::endl;
+
+	if(!config.convertPath.empty())
+		return convertPuzzles(config);
 
-	std::cout<< "Starting threads... " << std::endl;
-	run();
+	if(!config.benchmarkPath.empty())
+	{
+		Benchmark benchmark(config);
+
+		if(!benchmark.loadCorpus(config.benchmarkPath.c_str()))
+			return 1;
+		benchmark.generatePuzzles();
+		return benchmark.run();
+	}
 
-	theSolution.printBoard();
+	//A batch is meant to be run unattended, so it never waits on the console
+	if(!config.batchPath.empty())
+	{
+		BatchSolver batch(config);
+
+		if(!batch.loadPuzzles(config.batchPath.c_str()))
+			return 1;
+		return batch.run();
+	}
+
+	result = solveSingle(config);
 	//Just in case this wasn't run from the console, should be taken out later
 	system("PAUSE");
 
-	return 0;
+	return result;
 }
\ No newline at end of file
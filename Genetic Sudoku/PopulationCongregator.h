@@ -1,31 +1,95 @@
-/*	@Description: Creates an "overseer" of a number of threads that create genetic populations. Every x generations,
- *		each worker thread returns a set of Sudoku Puzzles, which the overseer than shuffles around and re-distributes.
- *		This process continues until an optimal solution to a Sudoku Puzzle has been found.
+/*	@Description: Creates an "overseer" of a number of genetic populations ("islands"), which are scheduled across a pool of
+ *		worker threads. Every x generations, each island sends some of its Sudoku Puzzles to its neighbouring islands through
+ *		lock-free queues, and takes in whatever its neighbours have sent it. Nobody waits on anybody else. This process continues
+ *		until an optimal solution to a Sudoku Puzzle has been found, or the solve runs out of time or evaluations.
+ *
+ *		A PopulationCongregator solves exactly one puzzle and keeps no global state, so any number of them can share one
+ *		TaskScheduler (see BatchSolver).
  */
 
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <thread>
+#include "CheckpointWriter.h"
+#include "ExactSolver.h"
 #include "GeneticPopulation.h"
+#include "MigrationQueue.h"
+#include "SolverConfig.h"
+#include "TaskScheduler.h"
 
-#define numThreads 4
+//How many migrants (per migrant sent each epoch) can be waiting between two islands before new ones get dropped
+#define migrationQueueSlotsPerMigrant 4
+//How long the exact solver gets to finish off the best board before it starts over from just the givens
+#define exactSeedNodeLimit 100000
 
-//Making this class-based makes it difficult to run threads, there'd have to be another layer of class-based abstraction which is gross and unecessary
-//	So instead, these are method prototypes for a "driver"
+class PopulationCongregator
+{
+private:
+	SolverConfig config;				//Everything configurable about the run
+	PuzzleDefinitionPtr definition;		//The puzzle being solved
+	TaskScheduler &scheduler;			//Work-stealing pool the islands run on, there can be more islands than threads
+	std::atomic<bool> optimalSolution;	//Whether or not a solved Sudoku Puzzle configuration has been found
+	std::atomic<bool> stopRequested;	//Islands stop between children (the exact solver between nodes) once this is set
+	std::atomic<bool> budgetExpired;	//Set if the solve was stopped because it ran out of time or evaluations
+	std::atomic<long long> evaluationsSpent;	//Across every island, only kept track of with an evaluation budget
+	std::chrono::high_resolution_clock::time_point deadline;	//When the time limit runs out, if there is one
+	std::atomic<bool> finished;			//Set once every task has stopped
+	std::atomic<int> migrationRounds;	//Total number of rounds (advancePopulation calls) across all the islands
+	std::atomic<int> lastImprovement;	//migrationRounds when bestSpecimen last improved
+	std::atomic<int> activeTasks;		//Islands (and the exact solver) that haven't stopped yet
+	std::atomic<bool> exactSolverStarted;
+	std::vector<std::vector<SudokuPuzzle>> islandConfigs;	//Used to distribute the initial Sudoku Puzzles to islands
+	std::vector<std::unique_ptr<GeneticPopulation>> islands;	//Created by each island's first task, so they're allocated by the thread that runs them
+	std::vector<std::unique_ptr<MigrationQueue>> migrationQueues;	//One queue per directed edge of the migration topology
+	std::vector<std::vector<MigrationQueue *>> outgoingQueues;		//For each island, the queues it pushes its migrants into
+	std::vector<std::vector<MigrationQueue *>> incomingQueues;		//For each island, the queues it pulls migrants out of
+	std::mutex threadMutex;				//Guards bestSpecimen, theSolution and the timings
+	std::condition_variable condVar;	//Wakes up whoever is waiting as soon as every task has stopped
+	SudokuPuzzle bestSpecimen;			//Most fit Sudoku Puzzle any island has reported so far
+	SudokuPuzzle theSolution;			//The solved Sudoku Puzzle for the given configuration
+	std::function<void()> onFinished;	//Called once every task has stopped
+	std::chrono::high_resolution_clock::time_point startTime;
+	std::chrono::high_resolution_clock::time_point endTime;
+	std::vector<IslandState> restoredIslands;	//Islands are created from these instead of from scratch when resuming
+	CheckpointWriter *checkpointWriter;	//Where finished checkpoints go, NULL if nothing is being checkpointed
+	std::atomic<int> checkpointRound;	//Bumped to ask every island for a snapshot at the end of its current epoch
+	std::vector<int> islandCheckpointRound;	//The last round each island took its snapshot for, only touched by that island's task
+	std::mutex checkpointMutex;			//Guards pendingCheckpoint and checkpointContributions
+	Checkpoint pendingCheckpoint;		//Filled in island by island, and handed to the checkpointWriter once every island is in
+	int checkpointContributions;
+	MetricsRegistry metrics;			//Every island publishes its counters here at the end of each epoch
 
-bool optimalSolution;	//Whether or not a solved Sudoku Puzzle configuration has been found
-int finishedThreads;	//Used in simulation of a barrier
-char *fileName;			//File used for initial Sudoku Puzzle configuration
-std::vector<SudokuPuzzle> overLordArray;	//Used to congregate populations from worker threads
-std::vector<std::vector<SudokuPuzzle>> threadConfigs;	//Used to distribute Sudoku Puzzles to threads
-std::vector<std::thread> threadPool;		
-std::mutex threadMutex;				//Used in simulation of a barrier
-std::condition_variable condVar;	//Used in simulation of a barrier
-SudokuPuzzle theSolution;			//The solved Sudoku Puzzle for the given configuration
+	void buildMigrationQueues();		//Creates the queues between islands according to config.migrationTopology
+	void reportBest(GeneticPopulation &);	//Updates bestSpecimen (and theSolution) if an island has beaten it
+	void runIslandEpoch(int);			//Task that advances an island for one epoch, migrates, and reschedules itself
+	void runExactSolver();				//Task that finishes the puzzle off with an ExactSolver once the islands have stalled
+	void taskStopped();					//Counts a task out, the last one finishes the solve
+	bool shouldStop(long long);			//Polled by the tasks with the evaluations they've made since their last poll, stops the solve if its budget has run out
+	void contributeCheckpoint(int, GeneticPopulation &);	//Adds an island's snapshot to the pending checkpoint, the last island in submits it
+public:
+	PopulationCongregator(PuzzleDefinitionPtr, const SolverConfig &, TaskScheduler &);
+	~PopulationCongregator();			//Stops the islands and waits for them
 
-void clearThreadConfigs();			//Clears all collected specimens after each generation
-void workerThread(int);				//Runs an instance of GeneticPopulation, simulates a "colony" of Sudoku Puzzles
-void init(char *);					//Necessary initializations
-void spawnThreads();				//Initializes the threadPool
-void run();							//Runs the PopulationCongregator (threadPools, colonies, and all)
+	void restore(const Checkpoint &);	//Resumes the islands (and counters) of a checkpoint taken with the same settings, before start
+	void setCheckpointWriter(CheckpointWriter *);
+	bool exportMetrics();				//Writes the islands' counters to config.metricsPath, false if there's nowhere to (or it's already being done)
+	bool requestCheckpoint();			//Asks the islands for a checkpoint, false if the last one is still being collected
+	void start(std::function<void()> = std::function<void()>());	//Schedules the islands' first tasks, the callback runs (on a worker) once every task has stopped
+	void stop();						//Asks the islands (and the exact solver) to stop without a solution
+	bool waitFor(int);					//Waits up to that many milliseconds, true if every task has stopped
+	void wait();
+	bool isFinished();
+	bool isSolved();
+	bool isBudgetExpired();				//Whether the solve ran out of time or evaluations, getBest is then the anytime result
+	int getGenerations();				//Average number of epochs each island has run
+	long long getTotalGenerations();	//Generations run across every island, only exact once every task has stopped
+	long long getTotalEvaluations();	//Fitness evaluations made across every island, same
+	long long getElapsedMilliseconds();	//From start until finishing (or until now, if still running)
+	SudokuPuzzle getBest();
+	SudokuPuzzle getSolution();
+};
\ No newline at end of file
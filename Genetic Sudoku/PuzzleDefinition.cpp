@@ -0,0 +1,275 @@
+#include "PuzzleDefinition.h"
+
+PuzzleDefinition::PuzzleDefinition(const std::vector<int> &initialBoard)
+{
+	int index;
+
+	givens.assign(initialBoard.begin(), initialBoard.end());
+	sizeOfBoard = (int) sqrt(givens.size());
+	sizeOfMacroBlock = (int) sqrt(sizeOfBoard);
+	countConflictsKernel = selectCountConflictsKernel(sizeOfBoard);
+	scoreBoardKernel = selectScoreBoardKernel(sizeOfBoard);
+
+	freeCells.resize(sizeOfBoard);
+	givenNumbers.assign(sizeOfBoard, 0);
+	blockCells.resize(sizeOfBoard * sizeOfBoard);
+	rowOf.resize(sizeOfBoard * sizeOfBoard);
+	colOf.resize(sizeOfBoard * sizeOfBoard);
+	blockOf.resize(sizeOfBoard * sizeOfBoard);
+
+	RandomGenerator zobristRandom(zobristSeed);
+	zobristKeys.resize(sizeOfBoard * sizeOfBoard * sizeOfBoard);
+	for(int i = 0; i < zobristKeys.size(); i++)
+		zobristKeys[i] = zobristRandom.next();
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		rowOf[i] = i / sizeOfBoard;
+		colOf[i] = i % sizeOfBoard;
+	}
+
+	//Walks every macroBlock once up front so nobody has to redo this per specimen
+	for(int block = 0; block < sizeOfBoard; block++)
+	{
+		for(int position = 0; position < sizeOfBoard; position++)
+		{
+			//Math wizardry to determine what position in the single-dimension array the cells match up to
+			index = convertCoordinates((block % sizeOfMacroBlock) * sizeOfMacroBlock + (position % sizeOfMacroBlock), (block / sizeOfMacroBlock) * sizeOfMacroBlock + (position / sizeOfMacroBlock), sizeOfBoard);
+			blockCells[convertCoordinates(position, block, sizeOfBoard)] = index;
+			blockOf[index] = block;
+		}
+	}
+
+	//Everything below treats the forced cells exactly like the original givens
+	propagateConstraints();
+
+	for(int block = 0; block < sizeOfBoard; block++)
+	{
+		for(int position = 0; position < sizeOfBoard; position++)
+		{
+			index = getCellIndex(block, position);
+
+			if(givens[index] > 0)
+				givenNumbers[block] |= 1ULL << (givens[index] - 1);
+			else
+				freeCells[block].push_back(index);
+		}
+	}
+}
+
+//Logical deductions, done once per puzzle before any searching happens:
+//	naked singles (a cell only has one candidate left) and hidden singles (a number only fits in one cell of some unit)
+//	Each one found becomes a given, which can force more cells, so this repeats until nothing changes
+void PuzzleDefinition::propagateConstraints()
+{
+	std::vector<int> numberCount;		//For the unit being looked at, how many cells each number could go in (-1 if it's already given)
+	std::vector<int> numberCell;		//And the last of those cells
+	unsigned long long remaining;
+	int index;
+	int number;
+	bool progress;
+
+	candidates.assign(sizeOfBoard * sizeOfBoard, (1ULL << sizeOfBoard) - 1);
+	numberCount.resize(sizeOfBoard);
+	numberCell.resize(sizeOfBoard);
+	forcedCells = 0;
+
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+		if(givens[i] > 0)
+			placeNumber(i, givens[i]);
+
+	do
+	{
+		progress = false;
+
+		//Naked singles
+		for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+		{
+			if(givens[i] > 0)
+				continue;
+
+			//Nothing fits, the puzzle has no solution. There's nothing left to deduce, the search just won't get to 0
+			if(candidates[i] == 0)
+				return;
+
+			if(countBits(candidates[i]) == 1)
+			{
+				placeNumber(i, countBits(candidates[i] - 1) + 1);
+				forcedCells++;
+				progress = true;
+			}
+		}
+
+		//Hidden singles
+		for(int unit = 0; unit < 3 * sizeOfBoard; unit++)
+		{
+			std::fill(numberCount.begin(), numberCount.end(), 0);
+
+			for(int position = 0; position < sizeOfBoard; position++)
+			{
+				index = unitCell(unit, position);
+				if(givens[index] > 0)
+				{
+					numberCount[givens[index] - 1] = -1;
+					continue;
+				}
+
+				for(remaining = candidates[index]; remaining != 0; remaining &= remaining - 1)
+				{
+					number = countBits((remaining & (~remaining + 1)) - 1);	//Lowest set bit
+					if(numberCount[number] >= 0)
+					{
+						numberCount[number]++;
+						numberCell[number] = index;
+					}
+				}
+			}
+
+			//A cell can't be the only place for two different numbers, unless the puzzle has no solution, so placed cells are skipped
+			for(number = 0; number < sizeOfBoard; number++)
+			{
+				if((numberCount[number] == 1) && (givens[numberCell[number]] == 0))
+				{
+					placeNumber(numberCell[number], number + 1);
+					forcedCells++;
+					progress = true;
+				}
+			}
+		}
+	} while(progress);
+}
+
+void PuzzleDefinition::placeNumber(int index, int number)
+{
+	unsigned long long numberMask;
+	int row;
+	int col;
+	int block;
+
+	numberMask = 1ULL << (number - 1);
+	row = rowOf[index];
+	col = colOf[index];
+	block = blockOf[index];
+
+	for(int position = 0; position < sizeOfBoard; position++)
+	{
+		candidates[unitCell(row, position)] &= ~numberMask;
+		candidates[unitCell(sizeOfBoard + col, position)] &= ~numberMask;
+		candidates[unitCell(2 * sizeOfBoard + block, position)] &= ~numberMask;
+	}
+
+	givens[index] = number;
+	candidates[index] = numberMask;
+}
+
+int PuzzleDefinition::unitCell(int unit, int position) const
+{
+	if(unit < sizeOfBoard)
+		return convertCoordinates(position, unit, sizeOfBoard);
+	if(unit < 2 * sizeOfBoard)
+		return convertCoordinates(unit - sizeOfBoard, position, sizeOfBoard);
+	return getCellIndex(unit - 2 * sizeOfBoard, position);
+}
+
+bool PuzzleDefinition::isValidShape(const std::vector<int> &initialBoard)
+{
+	int size;
+	int macroBlock;
+
+	size = (int) (sqrt((double) initialBoard.size()) + .5);
+	macroBlock = (int) (sqrt((double) size) + .5);
+	if((size == 0) || (size > 36) || (size * size != initialBoard.size()) || (macroBlock * macroBlock != size))
+		return false;
+
+	for(int i = 0; i < initialBoard.size(); i++)
+		if((initialBoard[i] < 0) || (initialBoard[i] > size))
+			return false;
+
+	return true;
+}
+
+int PuzzleDefinition::getSizeOfMacroBlock() const
+{
+	return sizeOfMacroBlock;
+}
+
+int PuzzleDefinition::getSizeOfBoard() const
+{
+	return sizeOfBoard;
+}
+
+const std::vector<Cell> &PuzzleDefinition::getGivens() const
+{
+	return givens;
+}
+
+bool PuzzleDefinition::isGiven(int index) const
+{
+	return (givens[index] != 0);
+}
+
+int PuzzleDefinition::getCellIndex(int block, int position) const
+{
+	return blockCells[convertCoordinates(position, block, sizeOfBoard)];
+}
+
+int PuzzleDefinition::getRow(int index) const
+{
+	return rowOf[index];
+}
+
+int PuzzleDefinition::getCol(int index) const
+{
+	return colOf[index];
+}
+
+int PuzzleDefinition::getBlock(int index) const
+{
+	return blockOf[index];
+}
+
+int PuzzleDefinition::countConflicts(const Cell *board, Cell *rowCounts, Cell *colCounts) const
+{
+	return countConflictsKernel(board, rowCounts, colCounts, sizeOfBoard);
+}
+
+int PuzzleDefinition::scoreBoard(const Cell *board) const
+{
+	return scoreBoardKernel(board, sizeOfBoard);
+}
+
+unsigned long long PuzzleDefinition::getZobristKey(int index, int number) const
+{
+	return zobristKeys[convertCoordinates(number - 1, index, sizeOfBoard)];
+}
+
+unsigned long long PuzzleDefinition::hashBoard(const Cell *board) const
+{
+	unsigned long long hash;
+
+	hash = 0;
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+		hash ^= zobristKeys[convertCoordinates(board[i] - 1, i, sizeOfBoard)];
+
+	return hash;
+}
+
+const std::vector<int> &PuzzleDefinition::getFreeCells(int block) const
+{
+	return freeCells[block];
+}
+
+unsigned long long PuzzleDefinition::getGivenNumbers(int block) const
+{
+	return givenNumbers[block];
+}
+
+unsigned long long PuzzleDefinition::getCandidates(int index) const
+{
+	return candidates[index];
+}
+
+int PuzzleDefinition::getNumForcedCells() const
+{
+	return forcedCells;
+}
\ No newline at end of file
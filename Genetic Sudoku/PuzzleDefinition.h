@@ -0,0 +1,62 @@
+#pragma once
+
+#include <math.h>
+#include <memory>
+#include <vector>
+#include "CSVReader.h"
+#include "FitnessKernels.h"
+#include "RandomGenerator.h"
+#include "Utils.h"
+
+//Zobrist keys are drawn from a fixed seed, so a board hashes the same in every run
+#define zobristSeed 0x9e3779b97f4a7c15ULL
+
+//Everything about a Sudoku Puzzle that doesn't change while it's being solved
+//	A single PuzzleDefinition is created per puzzle and shared (read-only) by every SudokuPuzzle of every GeneticPopulation,
+//	so specimens only have to carry their own board around
+class PuzzleDefinition
+{
+private:
+	int sizeOfMacroBlock;						//length of sides of each "macroBlock", or cell of a Sudoku Puzzle
+	int sizeOfBoard;							//the n of an n x n Sudoku Puzzle
+	std::vector<Cell> givens;					//Representation of the initial configuration of the Sudoku board, 0 represents empty space
+	std::vector<std::vector<int>> freeCells;	//For each macroBlock, the board indices of the cells that aren't givens
+	std::vector<unsigned long long> givenNumbers;	//For each macroBlock, bit (number - 1) is set if number is a given in it
+	std::vector<unsigned long long> candidates;	//For each cell, bit (number - 1) is set if number can legally go there given the givens
+	int forcedCells;							//How many givens were added by constraint propagation
+
+	//Lookup tables so nobody has to do the div/mod math wizardry on the hot paths
+	std::vector<int> blockCells;				//Board index of each (macroBlock, position within macroBlock), indexed by convertCoordinates(position, macroBlock, sizeOfBoard)
+	std::vector<Cell> rowOf;					//Row of each board index
+	std::vector<Cell> colOf;					//Column of each board index
+	std::vector<Cell> blockOf;					//macroBlock of each board index
+	std::vector<unsigned long long> zobristKeys;	//Random key for each (board index, number), indexed by convertCoordinates(number - 1, index, sizeOfBoard)
+	CountConflictsKernel countConflictsKernel;	//Full fitness evaluation that also builds conflict counts, specialized for sizeOfBoard when possible
+	ScoreBoardKernel scoreBoardKernel;			//Fitness-only evaluation, picked at runtime depending on sizeOfBoard and the CPU
+
+	void propagateConstraints();				//Turns every cell the givens force into another given, and fills in candidates
+	void placeNumber(int, int);					//Makes (index, number) a given and takes number out of the candidates of every cell that shares a unit with it
+	int unitCell(int, int) const;				//Board index of a position within a unit (rows, then columns, then macroBlocks)
+public:
+	PuzzleDefinition(const std::vector<int> &);	//Creates a definition from an initial Sudoku configuration
+	static bool isValidShape(const std::vector<int> &);	//Whether a configuration is n^2 x n^2 (up to 36x36) with every number in range
+
+	int getSizeOfMacroBlock() const;
+	int getSizeOfBoard() const;
+	const std::vector<Cell> &getGivens() const;
+	bool isGiven(int) const;									//Whether the cell at some board index is part of the initial configuration
+	int getCellIndex(int, int) const;							//Board index of a position (0 for top-left, sizeOfBoard-1 for bottom right) within a macroBlock
+	int getRow(int) const;
+	int getCol(int) const;
+	int getBlock(int) const;
+	int countConflicts(const Cell *, Cell *, Cell *) const;		//Runs the full fitness evaluation kernel on (board, rowCounts, colCounts)
+	int scoreBoard(const Cell *) const;							//Runs the fitness-only kernel on a board
+	unsigned long long getZobristKey(int, int) const;			//Key of (board index, number), a board's hash is the xor of the keys of all its cells
+	unsigned long long hashBoard(const Cell *) const;			//Zobrist hash of a whole board, swaps can update it with just four keys
+	const std::vector<int> &getFreeCells(int) const;			//Board indices of the non-given cells of a macroBlock
+	unsigned long long getGivenNumbers(int) const;				//Bitmask of the numbers given in a macroBlock
+	unsigned long long getCandidates(int) const;				//Bitmask of the numbers that can legally go in the cell at some board index
+	int getNumForcedCells() const;
+};
+
+typedef std::shared_ptr<const PuzzleDefinition> PuzzleDefinitionPtr;
\ No newline at end of file
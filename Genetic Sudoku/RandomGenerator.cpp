@@ -0,0 +1,104 @@
+#include "RandomGenerator.h"
+
+RandomGenerator::RandomGenerator()
+{
+	seed(0);
+}
+
+RandomGenerator::RandomGenerator(unsigned long long initialSeed)
+{
+	seed(initialSeed);
+}
+
+//SplitMix64, recommended by the xoshiro authors for seeding since it never produces the all-zero state
+unsigned long long RandomGenerator::splitMix(unsigned long long &value)
+{
+	unsigned long long result;
+
+	value += 0x9e3779b97f4a7c15ULL;
+	result = value;
+	result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	result = (result ^ (result >> 27)) * 0x94d049bb133111ebULL;
+	return result ^ (result >> 31);
+}
+
+void RandomGenerator::seed(unsigned long long initialSeed)
+{
+	for(int i = 0; i < 4; i++)
+		state[i] = splitMix(initialSeed);
+}
+
+void RandomGenerator::getState(unsigned long long *savedState) const
+{
+	for(int i = 0; i < 4; i++)
+		savedState[i] = state[i];
+}
+
+void RandomGenerator::setState(const unsigned long long *savedState)
+{
+	for(int i = 0; i < 4; i++)
+		state[i] = savedState[i];
+}
+
+//xoshiro256** (Blackman & Vigna)
+unsigned long long RandomGenerator::next()
+{
+	unsigned long long result;
+	unsigned long long shifted;
+
+	result = state[1] * 5;
+	result = ((result << 7) | (result >> 57)) * 9;
+	shifted = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = (state[3] << 45) | (state[3] >> 19);
+
+	return result;
+}
+
+//Lemire's multiply-and-reject method: maps 32 random bits onto [0, bound) with a multiply instead of a modulo,
+//	and throws away the few values that would make some results more likely than others
+int RandomGenerator::nextInt(int bound)
+{
+	unsigned int range;
+	unsigned int threshold;
+	unsigned long long product;
+
+	range = (unsigned int) bound;
+	product = (next() >> 32) * range;
+
+	if((unsigned int) product < range)
+	{
+		threshold = (0U - range) % range;
+		while((unsigned int) product < threshold)
+			product = (next() >> 32) * range;
+	}
+
+	return (int) (product >> 32);
+}
+
+void RandomGenerator::fillInts(int *output, int count, int bound)
+{
+	for(int i = 0; i < count; i++)
+		output[i] = nextInt(bound);
+}
+
+//The top 53 bits fill the whole mantissa
+double RandomGenerator::nextDouble()
+{
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+RandomGenerator RandomGenerator::split()
+{
+	return RandomGenerator(next());
+}
+
+RandomGenerator::result_type RandomGenerator::operator()()
+{
+	return next();
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+//std::shuffle needs the generator's bounds to be constant expressions on newer compilers, VS2012 doesn't have constexpr at all
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#define GENERATOR_CONSTEXPR
+#else
+#define GENERATOR_CONSTEXPR constexpr
+#endif
+
+//xoshiro256** pseudo-random number generator
+//	Every GeneticPopulation (and every worker thread) owns one of these instead of sharing the C library's rand(), which is
+//	global state across threads, only guarantees 15 bits, and is biased when taken % some range
+//	Runs are reproducible: the same seed always produces the same sequence
+class RandomGenerator
+{
+private:
+	unsigned long long state[4];
+
+	static unsigned long long splitMix(unsigned long long &);	//Used to expand a single seed into the full state
+public:
+	RandomGenerator();							//Seeds with 0, so default objects are still usable
+	RandomGenerator(unsigned long long);		//Seeds with some value
+
+	void seed(unsigned long long);
+	unsigned long long next();					//64 uniformly distributed random bits
+	int nextInt(int);							//Unbiased random number in [0, bound)
+	double nextDouble();						//Uniformly distributed in [0, 1)
+	void fillInts(int *, int, int);				//Fills (output, count) with unbiased random numbers in [0, bound)
+	void getState(unsigned long long *) const;	//Copies out the 4 words of state, so a checkpoint can pick the sequence back up exactly
+	void setState(const unsigned long long *);
+	RandomGenerator split();					//Creates an independent generator seeded off of this one, for handing out to other threads/populations
+
+	//Lets this be used as the generator for std::shuffle (min and max are parenthesized so windows.h's macros leave them alone)
+	typedef unsigned long long result_type;
+	static GENERATOR_CONSTEXPR result_type (min)() { return 0; }
+	static GENERATOR_CONSTEXPR result_type (max)() { return ~0ULL; }
+	result_type operator()();					//Same as next
+};
\ No newline at end of file
@@ -0,0 +1,347 @@
+#include "SolverConfig.h"
+
+SolverConfig getDefaultConfig()
+{
+	SolverConfig config;
+
+	config.fileName = "sudoku1.csv";
+	config.seed = (unsigned long long) std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	config.numThreads = std::thread::hardware_concurrency();
+	if(config.numThreads <= 0)	//hardware_concurrency is allowed to not know
+		config.numThreads = 4;
+	config.numIslands = 0;	//Filled in with numThreads once the command line has been parsed
+	config.populationSize = defaultPopulationSize;
+	config.breedingTasks = 1;
+	config.numberOfGenerations = defaultNumberOfGenerations;
+	config.numberOfMigrants = defaultNumberOfMigrants;
+	config.randomPercent = defaultRandomPercent;
+	config.migrationTopology = ringTopology;
+	config.stagnationEpochs = defaultStagnationEpochs;
+	config.localSearch = exhaustiveLocalSearch;
+	config.selection = rankedSelection;
+	config.operatorSelection = fixedOperators;
+	config.timeLimit = 0;
+	config.evaluationBudget = 0;
+	config.pinThreads = false;
+	config.concurrentPuzzles = 0;
+	config.checkpointInterval = defaultCheckpointInterval;
+	config.metricsFormat = jsonMetrics;
+	config.benchmarkSeeds = defaultBenchmarkSeeds;
+	config.benchmarkClues = defaultBenchmarkClues;
+	config.benchmarkTimeLimit = defaultBenchmarkTimeLimit;
+	config.benchmarkSizes.push_back(9);
+	config.benchmarkSizes.push_back(16);
+	config.benchmarkSizes.push_back(25);
+	config.benchmarkSizes.push_back(36);
+
+	return config;
+}
+
+//Reads a comma-separated list of board sizes (9, 16, 25 or 36, or 4), "none" for an empty list
+static bool parseSizes(const std::string &value, std::vector<int> &sizes)
+{
+	size_t start;
+	size_t end;
+	int size;
+	int root;
+
+	sizes.clear();
+	if(value == "none")
+		return true;
+
+	for(start = 0; start <= value.size(); start = end + 1)
+	{
+		end = value.find(',', start);
+		if(end == std::string::npos)
+			end = value.size();
+
+		size = atoi(value.substr(start, end - start).c_str());
+		root = (int) (sqrt((double) size) + 0.5);
+		if((size < 4) || (size > 36) || (root * root != size))
+			return false;
+		sizes.push_back(size);
+	}
+
+	return true;
+}
+
+//Applies a single option, shared by the command line and config file parsers
+static bool applyOption(const std::string &key, const std::string &value, SolverConfig &config)
+{
+	if(key == "islands")
+		config.numIslands = atoi(value.c_str());
+	else if(key == "threads")
+		config.numThreads = atoi(value.c_str());
+	else if(key == "population")
+		config.populationSize = atoi(value.c_str());
+	else if(key == "breeding-tasks")
+		config.breedingTasks = atoi(value.c_str());
+	else if(key == "generations")
+		config.numberOfGenerations = atoi(value.c_str());
+	else if(key == "migrants")
+		config.numberOfMigrants = atoi(value.c_str());
+	else if(key == "random-percent")
+		config.randomPercent = atoi(value.c_str());
+	else if(key == "stagnation")
+		config.stagnationEpochs = atoi(value.c_str());
+	else if(key == "time-limit")
+		config.timeLimit = atoi(value.c_str());
+	else if(key == "evaluation-budget")
+		config.evaluationBudget = strtoll(value.c_str(), NULL, 10);
+	else if(key == "seed")
+		config.seed = strtoull(value.c_str(), NULL, 10);
+	else if(key == "batch")
+		config.batchPath = value;
+	else if(key == "concurrent")
+		config.concurrentPuzzles = atoi(value.c_str());
+	else if(key == "checkpoint")
+		config.checkpointPath = value;
+	else if(key == "checkpoint-interval")
+		config.checkpointInterval = atoi(value.c_str());
+	else if(key == "resume")
+		config.resumePath = value;
+	else if(key == "metrics")
+		config.metricsPath = value;
+	else if(key == "metrics-format")
+	{
+		if(value == "json")
+			config.metricsFormat = jsonMetrics;
+		else if(value == "prometheus")
+			config.metricsFormat = prometheusMetrics;
+		else
+			return false;
+	}
+	else if(key == "benchmark")
+		config.benchmarkPath = value;
+	else if(key == "bench-seeds")
+		config.benchmarkSeeds = atoi(value.c_str());
+	else if(key == "bench-sizes")
+		return parseSizes(value, config.benchmarkSizes);
+	else if(key == "bench-clues")
+		config.benchmarkClues = atoi(value.c_str());
+	else if(key == "bench-time-limit")
+		config.benchmarkTimeLimit = atoi(value.c_str());
+	else if(key == "convert")
+		config.convertPath = value;
+	else if(key == "pin")
+		config.pinThreads = (value != "0") && (value != "false");
+	else if(key == "topology")
+	{
+		if(value == "ring")
+			config.migrationTopology = ringTopology;
+		else if(value == "torus")
+			config.migrationTopology = torusTopology;
+		else if(value == "full")
+			config.migrationTopology = fullyConnectedTopology;
+		else
+			return false;
+	}
+	else if(key == "local-search")
+	{
+		if(value == "exhaustive")
+			config.localSearch = exhaustiveLocalSearch;
+		else if(value == "tabu")
+			config.localSearch = tabuLocalSearch;
+		else if(value == "annealing")
+			config.localSearch = annealingLocalSearch;
+		else if(value == "mixed")
+			config.localSearch = mixedLocalSearch;
+		else
+			return false;
+	}
+	else if(key == "selection")
+	{
+		if(value == "ranked")
+			config.selection = rankedSelection;
+		else if(value == "tournament")
+			config.selection = tournamentSelection;
+		else if(value == "truncation")
+			config.selection = truncationSelection;
+		else if(value == "rank-weighted")
+			config.selection = rankWeightedSelection;
+		else
+			return false;
+	}
+	else if(key == "operators")
+	{
+		if(value == "fixed")
+			config.operatorSelection = fixedOperators;
+		else if(value == "adaptive")
+			config.operatorSelection = adaptiveOperators;
+		else
+			return false;
+	}
+	else
+		return false;
+
+	return true;
+}
+
+//Trims spaces and tabs off of both ends
+static std::string trim(const std::string &text)
+{
+	size_t start;
+	size_t end;
+
+	start = text.find_first_not_of(" \t\r");
+	if(start == std::string::npos)
+		return std::string();
+	end = text.find_last_not_of(" \t\r");
+
+	return text.substr(start, end - start + 1);
+}
+
+bool loadConfigFile(const char *configFileName, SolverConfig &config)
+{
+	std::ifstream file(configFileName);
+	std::string lineBuffer;
+	size_t separator;
+
+	if(!file)
+	{
+		std::cerr << "Could not open config file." << std::endl;
+		return false;
+	}
+
+	while(std::getline(file, lineBuffer))
+	{
+		lineBuffer = trim(lineBuffer.substr(0, lineBuffer.find('#')));	//Everything after a # is a comment
+		if(lineBuffer.empty())
+			continue;
+
+		separator = lineBuffer.find('=');
+		if((separator == std::string::npos) || !applyOption(trim(lineBuffer.substr(0, separator)), trim(lineBuffer.substr(separator + 1)), config))
+		{
+			std::cerr << "Bad config line: " << lineBuffer << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Usage: <puzzle file> [seed] [--option value]...
+//	The puzzle file and seed can still be given positionally, like before there were any options
+bool parseCommandLine(int argc, char **argv, SolverConfig &config)
+{
+	int positional;
+
+	positional = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strncmp(argv[i], "--", 2) == 0)
+		{
+			std::string key(argv[i] + 2);
+
+			if(key == "pin")	//The only flag without a value
+			{
+				config.pinThreads = true;
+				continue;
+			}
+			if(i + 1 >= argc)
+				return false;
+
+			if(key == "config")
+			{
+				if(!loadConfigFile(argv[++i], config))
+					return false;
+			}
+			else if(!applyOption(key, argv[++i], config))
+				return false;
+		}
+		else if(positional == 0)
+		{
+			config.fileName = argv[i];
+			positional++;
+		}
+		else if(positional == 1)
+		{
+			config.seed = strtoull(argv[i], NULL, 10);
+			positional++;
+		}
+		else
+			return false;
+	}
+
+	//Unless asked otherwise, there's an island for every thread. A batch already has plenty of puzzles to keep the threads busy,
+	//	so each puzzle just gets one island, and there are a couple of puzzles per thread so nobody idles while a new one starts up
+	if(config.numIslands <= 0)
+		config.numIslands = config.batchPath.empty() ? config.numThreads : 1;
+	if(config.concurrentPuzzles <= 0)
+		config.concurrentPuzzles = std::max(1, 2 * config.numThreads / config.numIslands);
+
+	return (config.numIslands > 0) && (config.numThreads > 0) && (config.populationSize >= 10) && (config.breedingTasks > 0) && (config.breedingTasks <= config.populationSize) && (config.numberOfGenerations > 0) && (config.numberOfMigrants > 0) && (config.numberOfMigrants <= config.populationSize) && (config.randomPercent > 0) && (config.stagnationEpochs >= 0) && (config.timeLimit >= 0) && (config.evaluationBudget >= 0) && (config.checkpointInterval > 0) && (config.benchmarkSeeds > 0) && (config.benchmarkClues >= 0) && (config.benchmarkClues <= 100) && (config.benchmarkTimeLimit > 0);
+}
+
+void printUsage()
+{
+	std::cout << "Usage: GeneticSudoku <puzzle.csv> [seed] [options]" << std::endl;
+	std::cout << "  --islands N        number of island populations (default: one per thread)" << std::endl;
+	std::cout << "  --threads N        number of worker threads (default: hardware threads)" << std::endl;
+	std::cout << "  --population N     members per island (default " << defaultPopulationSize << ")" << std::endl;
+	std::cout << "  --breeding-tasks N split each generation's children into N shares that idle threads can breed, for fewer islands than threads (default 1)" << std::endl;
+	std::cout << "  --generations N    generations between migrations (default " << defaultNumberOfGenerations << ")" << std::endl;
+	std::cout << "  --migrants N       migrants sent per migration (default " << defaultNumberOfMigrants << ")" << std::endl;
+	std::cout << "  --random-percent N 1 in N crossover swaps are made anyway (default " << defaultRandomPercent << ")" << std::endl;
+	std::cout << "  --topology T       ring, torus or full (default ring)" << std::endl;
+	std::cout << "  --local-search L   exhaustive, tabu, annealing or mixed (default exhaustive)" << std::endl;
+	std::cout << "  --selection S      ranked, tournament, truncation or rank-weighted (default ranked)" << std::endl;
+	std::cout << "  --operators O      fixed, or adaptive to have each island learn which operators pay off (default fixed)" << std::endl;
+	std::cout << "  --stagnation N     epochs without improvement before the exact solver finishes the puzzle, 0 for never (default " << defaultStagnationEpochs << ")" << std::endl;
+	std::cout << "  --time-limit MS    stop each solve after MS milliseconds and take its best board so far (default: no limit)" << std::endl;
+	std::cout << "  --evaluation-budget N  stop each solve after N fitness evaluations and take its best board so far (default: no limit)" << std::endl;
+	std::cout << "  --seed N           random seed" << std::endl;
+	std::cout << "  --batch PATH       solve every puzzle in a directory, or in a file of puzzles (CSV grids, or one puzzle per line) (- for stdin)" << std::endl;
+	std::cout << "  --concurrent N     puzzles a batch solves at once (default: two per thread)" << std::endl;
+	std::cout << "  --checkpoint FILE  periodically save the run's state to FILE (single puzzle only)" << std::endl;
+	std::cout << "  --checkpoint-interval N  seconds between checkpoints (default " << defaultCheckpointInterval << ")" << std::endl;
+	std::cout << "  --resume FILE      pick a run back up from a checkpoint, its settings replace the ones given" << std::endl;
+	std::cout << "  --convert FILE     write the puzzle (or the puzzles of a --batch file) to FILE in the binary format, without solving" << std::endl;
+	std::cout << "  --metrics FILE     export per-operator counters to FILE every migration round (single puzzle only)" << std::endl;
+	std::cout << "  --metrics-format F json or prometheus (default json)" << std::endl;
+	std::cout << "  --benchmark DIR    benchmark the puzzles in DIR (SudokuPuzzles, say) plus generated ones, and the fitness primitives" << std::endl;
+	std::cout << "  --bench-seeds N    runs per benchmark puzzle, with seeds 1 to N (default " << defaultBenchmarkSeeds << ")" << std::endl;
+	std::cout << "  --bench-sizes L    comma-separated sizes of the generated puzzles, or none (default 9,16,25,36)" << std::endl;
+	std::cout << "  --bench-clues N    percent of the cells generated puzzles give (default " << defaultBenchmarkClues << ")" << std::endl;
+	std::cout << "  --bench-time-limit N  seconds a benchmark solve gets before it counts as unsolved (default " << defaultBenchmarkTimeLimit << ")" << std::endl;
+	std::cout << "  --pin              pin each worker thread to its own core" << std::endl;
+	std::cout << "  --config FILE      read \"key = value\" options from FILE" << std::endl;
+}
+
+//readCheckpoint rejects enum settings out of these ranges, so they have to keep up with the enums
+static_assert(fullyConnectedTopology + 1 == checkpointTopologies, "checkpointTopologies is out of date");
+static_assert(mixedLocalSearch + 1 == checkpointLocalSearches, "checkpointLocalSearches is out of date");
+static_assert(rankWeightedSelection + 1 == checkpointSelections, "checkpointSelections is out of date");
+static_assert(adaptiveOperators + 1 == checkpointOperatorSelections, "checkpointOperatorSelections is out of date");
+
+void saveCheckpointSettings(const SolverConfig &config, Checkpoint &checkpoint)
+{
+	checkpoint.seed = config.seed;
+	checkpoint.populationSize = config.populationSize;
+	checkpoint.numberOfGenerations = config.numberOfGenerations;
+	checkpoint.numberOfMigrants = config.numberOfMigrants;
+	checkpoint.randomPercent = config.randomPercent;
+	checkpoint.stagnationEpochs = config.stagnationEpochs;
+	checkpoint.migrationTopology = config.migrationTopology;
+	checkpoint.localSearch = config.localSearch;
+	checkpoint.selection = config.selection;
+	checkpoint.operatorSelection = config.operatorSelection;
+	checkpoint.breedingTasks = config.breedingTasks;
+}
+
+void loadCheckpointSettings(const Checkpoint &checkpoint, SolverConfig &config)
+{
+	config.seed = checkpoint.seed;
+	config.populationSize = checkpoint.populationSize;
+	config.numberOfGenerations = checkpoint.numberOfGenerations;
+	config.numberOfMigrants = checkpoint.numberOfMigrants;
+	config.randomPercent = checkpoint.randomPercent;
+	config.stagnationEpochs = checkpoint.stagnationEpochs;
+	config.migrationTopology = (MigrationTopology) checkpoint.migrationTopology;
+	config.localSearch = (LocalSearchOperator) checkpoint.localSearch;
+	config.selection = (SelectionStrategy) checkpoint.selection;
+	config.operatorSelection = (OperatorSelection) checkpoint.operatorSelection;
+	config.breedingTasks = checkpoint.breedingTasks;
+	config.numIslands = (int) checkpoint.islands.size();
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BinaryFormat.h"
+#include "LocalSearch.h"
+#include "Metrics.h"
+#include "OperatorBandit.h"
+#include "MigrationQueue.h"
+#include "SpecimenPool.h"
+
+//Defaults for everything that can be configured at runtime. These numbers can be tweaked
+#define defaultPopulationSize 130
+#define defaultNumberOfGenerations 100
+//numberOfMigrants is how many specimens each population sends out (and takes in) every time populations are mixed
+#define defaultNumberOfMigrants 13
+#define defaultRandomPercent 20
+//Epochs (per island) without the best fitness improving before the exact solver is brought in
+#define defaultStagnationEpochs 10
+//Seconds between checkpoints, when checkpointing
+#define defaultCheckpointInterval 60
+//Benchmark runs: how many fixed seeds every puzzle is solved with, what percent of the cells generated puzzles give away,
+//	and how many seconds a single solve gets before it counts as unsolved
+#define defaultBenchmarkSeeds 5
+#define defaultBenchmarkClues 40
+#define defaultBenchmarkTimeLimit 30
+
+//Everything about a run that used to be a compile-time constant
+//	Filled in from the command line and/or a config file, see parseCommandLine for the options
+struct SolverConfig
+{
+	std::string fileName;				//File used for initial Sudoku Puzzle configuration
+	unsigned long long seed;			//Seed everything random in a run is derived from, the same seed reproduces the same populations
+	int numIslands;						//How many GeneticPopulations there are, can be more than numThreads (0 for one per thread)
+	int numThreads;						//How many worker threads the islands are scheduled across
+	int populationSize;					//Members of each island's genePool
+	int breedingTasks;					//Shares each island breeds a generation's children in, which idle threads can take on (1 to breed them one after another)
+	int numberOfGenerations;			//Generations an island runs between migrations (its epoch length)
+	int numberOfMigrants;
+	int randomPercent;					//1 in randomPercent crossover swaps are performed regardless of whether they help
+	MigrationTopology migrationTopology;
+	LocalSearchOperator localSearch;	//What the local search post-mate mutations do
+	SelectionStrategy selection;		//How parents are selected, only rankedSelection sorts the populations every generation
+	OperatorSelection operatorSelection;	//Whether the crossover and mutation operators are picked with fixed odds or learnt per island
+	int stagnationEpochs;				//How long the search can stall before the exact solver takes over (0 to never use it)
+	int timeLimit;						//Milliseconds a solve gets before its best board so far is taken as the result (0 for no limit)
+	long long evaluationBudget;			//Fitness evaluations (full, or of a single swap) a solve gets across all of its islands (0 for no limit)
+	bool pinThreads;					//Whether each worker thread is pinned to its own core
+	std::string batchPath;				//Directory or multi-puzzle file to solve in batch mode, empty to solve fileName on its own
+	int concurrentPuzzles;				//How many puzzles a batch solves at once (0 to fill up the threads)
+	std::string checkpointPath;			//File the state of a single-puzzle run is checkpointed to, empty for no checkpoints
+	int checkpointInterval;				//Seconds between checkpoints
+	std::string resumePath;				//Checkpoint (or binary puzzle file) to pick a run back up from, instead of reading fileName
+	std::string metricsPath;			//File the operator and phase counters are exported to every migration round, empty for none (single puzzle only)
+	MetricsFormat metricsFormat;
+	std::string benchmarkPath;			//If set, the puzzles in this directory (plus generated ones) are benchmarked instead of solving fileName
+	int benchmarkSeeds;					//Runs per benchmark puzzle, with seeds 1 to benchmarkSeeds
+	std::vector<int> benchmarkSizes;	//Sizes of the puzzles the benchmark generates (and micro-benchmarks), 9 for 9x9 and so on
+	int benchmarkClues;					//Percent of the cells of a generated puzzle that are givens
+	int benchmarkTimeLimit;				//Seconds a benchmark solve gets before it's stopped and counted as unsolved
+	std::string convertPath;			//If set, the puzzles (of fileName, or of a batchPath file) are written here as a binary puzzle file instead of being solved
+};
+
+SolverConfig getDefaultConfig();						//Defaults, with a thread (and island) per hardware thread
+bool loadConfigFile(const char *, SolverConfig &);		//Reads "key = value" lines (same keys as the command line options, without the dashes)
+bool parseCommandLine(int, char **, SolverConfig &);	//Fills in a config from argv, false if something couldn't be parsed
+void printUsage();
+void saveCheckpointSettings(const SolverConfig &, Checkpoint &);	//Copies the settings a run's state depends on into a checkpoint
+void loadCheckpointSettings(const Checkpoint &, SolverConfig &);	//Puts them back, the number of islands comes from the checkpoint too
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "SpecimenPool.h"
+
+BoardArena::BoardArena(int boardCells, int numBoards)
+{
+	cells.resize(boardCells * numBoards);
+	cellsPerBoard = boardCells;
+	boardsHandedOut = 0;
+}
+
+Cell *BoardArena::nextBoard()
+{
+	assert(boardsHandedOut * cellsPerBoard < cells.size());
+
+	return &cells[cellsPerBoard * boardsHandedOut++];
+}
+
+//This lets you call SpecimenPool x;
+SpecimenPool::SpecimenPool()
+{
+	cellsPerBoard = 0;
+	bestSlot = 0;
+	bestKnown = false;
+}
+
+SpecimenPool::SpecimenPool(PuzzleDefinitionPtr existingDefinition, int numSlots)
+{
+	int boardCells;
+
+	boardCells = existingDefinition->getSizeOfBoard() * existingDefinition->getSizeOfBoard();
+	*this = SpecimenPool(existingDefinition, numSlots, std::make_shared<BoardArena>(boardCells, numSlots));
+}
+
+SpecimenPool::SpecimenPool(PuzzleDefinitionPtr existingDefinition, int numSlots, BoardArenaPtr existingArena)
+{
+	definition = existingDefinition;
+	cellsPerBoard = definition->getSizeOfBoard() * definition->getSizeOfBoard();
+	arena = existingArena;
+
+	//Everything is allocated up front, nothing is allocated once the pool is in use
+	slotBoards.resize(numSlots);
+	for(int i = 0; i < numSlots; i++)
+		slotBoards[i] = arena->nextBoard();
+	fitness.resize(numSlots);
+	ranking.resize(numSlots);
+	sortKeys.resize(numSlots);
+	hashes.assign(numSlots, 0);
+	storedHashes.assign(numSlots, 0);
+	memberHashes = BoardHashSet(numSlots);
+
+	//Empty slots all count as having hash 0, so every slot is always in memberHashes exactly once
+	for(int i = 0; i < numSlots; i++)
+	{
+		ranking[i] = i;
+		memberHashes.insert(0);
+	}
+
+	bestSlot = 0;
+	bestKnown = false;
+}
+
+int SpecimenPool::size()
+{
+	return (int) fitness.size();
+}
+
+Cell *SpecimenPool::getBoard(int slot)
+{
+	return slotBoards[slot];
+}
+
+int SpecimenPool::getFitness(int slot)
+{
+	return fitness[slot];
+}
+
+void SpecimenPool::setFitness(int slot, int newFitness)
+{
+	fitness[slot] = newFitness;
+	noteFitness(slot);
+}
+
+unsigned long long SpecimenPool::getHash(int slot)
+{
+	return hashes[slot];
+}
+
+bool SpecimenPool::containsHash(unsigned long long hash)
+{
+	return memberHashes.contains(hash);
+}
+
+void SpecimenPool::setHash(int slot, unsigned long long hash)
+{
+	memberHashes.remove(hashes[slot]);
+	hashes[slot] = hash;
+	memberHashes.insert(hash);
+}
+
+//The only write that has to hash the board from scratch, everything else brings its hash along
+void SpecimenPool::storeBoard(int slot, const Cell *board)
+{
+	std::copy(board, board + cellsPerBoard, getBoard(slot));
+	setHash(slot, definition->hashBoard(board));
+}
+
+void SpecimenPool::store(int slot, const SudokuPuzzle &specimen)
+{
+	std::copy(specimen.getBoard().begin(), specimen.getBoard().end(), getBoard(slot));
+	setHash(slot, specimen.getHash());
+	fitness[slot] = specimen.getFitness();
+	noteFitness(slot);
+}
+
+//The hash set and best slot are shared by every slot, so they're left for indexStored
+void SpecimenPool::storeUnindexed(int slot, const SudokuPuzzle &specimen)
+{
+	std::copy(specimen.getBoard().begin(), specimen.getBoard().end(), getBoard(slot));
+	storedHashes[slot] = specimen.getHash();
+	fitness[slot] = specimen.getFitness();
+}
+
+//The best slot is found again by the next getBest(), ties go to the lowest slot just as they do when slots are stored one by one
+void SpecimenPool::indexStored()
+{
+	for(int i = 0; i < size(); i++)
+		setHash(i, storedHashes[i]);
+
+	bestKnown = false;
+}
+
+//The other slot is left with this one's old board, under its own fitness and hash, so it still ranks and compares the way it did,
+//	but its board is no longer the one those belong to and has to be written over before anything reads it
+void SpecimenPool::takeSlot(int slot, SpecimenPool &other, int otherSlot)
+{
+	assert(arena == other.arena);
+
+	std::swap(slotBoards[slot], other.slotBoards[otherSlot]);
+	setHash(slot, other.getHash(otherSlot));
+	fitness[slot] = other.getFitness(otherSlot);
+	noteFitness(slot);
+}
+
+SudokuPuzzle SpecimenPool::extract(int slot)
+{
+	return SudokuPuzzle(definition, getBoard(slot));
+}
+
+//Every board is somewhere in the one arena, so this sweeps a single block of memory (if not always in order)
+void SpecimenPool::evaluateAll()
+{
+	for(int i = 0; i < size(); i++)
+		fitness[i] = definition->scoreBoard(getBoard(i));
+
+	bestKnown = false;
+}
+
+//A better board takes over as the best, the best getting worse means the best has to be looked for again
+//	Ties go to the lowest slot, same as a fresh search would, so the best only ever depends on what's in the pool
+void SpecimenPool::noteFitness(int slot)
+{
+	if(!bestKnown)
+		return;
+
+	if((fitness[slot] < fitness[bestSlot]) || ((fitness[slot] == fitness[bestSlot]) && (slot < bestSlot)))
+		bestSlot = slot;
+	else if((slot == bestSlot) && (fitness[slot] > 0))
+		bestKnown = false;
+}
+
+//Sorting packed (fitness, slot) keys keeps the sort to a single array of integers, the slot just rides along in the low bits
+void SpecimenPool::packSortKeys()
+{
+	for(int i = 0; i < size(); i++)
+		sortKeys[i] = ((unsigned long long) fitness[i] << 32) | (unsigned int) i;
+}
+
+void SpecimenPool::rank()
+{
+	packSortKeys();
+	std::sort(sortKeys.begin(), sortKeys.end());
+
+	for(int i = 0; i < size(); i++)
+		ranking[i] = (int) (sortKeys[i] & 0xffffffffULL);
+
+	bestSlot = ranking[0];
+	bestKnown = true;
+}
+
+//Same keys as rank(), but nth_element only splits them around the n-th, which is all truncation needs
+void SpecimenPool::partition(int count)
+{
+	if((count <= 0) || (count >= size()))
+	{
+		rank();
+		return;
+	}
+
+	packSortKeys();
+	std::nth_element(sortKeys.begin(), sortKeys.begin() + count, sortKeys.end());
+
+	for(int i = 0; i < size(); i++)
+		ranking[i] = (int) (sortKeys[i] & 0xffffffffULL);
+}
+
+int SpecimenPool::getRanked(int rank)
+{
+	return ranking[rank];
+}
+
+//One pass over the fitnesses, and only when the old best was overwritten by something worse
+int SpecimenPool::getBest()
+{
+	if(!bestKnown)
+	{
+		bestSlot = (int) (std::min_element(fitness.begin(), fitness.end()) - fitness.begin());
+		bestKnown = true;
+	}
+
+	return bestSlot;
+}
+
+int SpecimenPool::tournament(int contestants, RandomGenerator &random, bool fittest)
+{
+	int winner;
+	int contender;
+
+	winner = random.nextInt(size());
+	for(int i = 1; i < contestants; i++)
+	{
+		contender = random.nextInt(size());
+		if(fittest ? (fitness[contender] < fitness[winner]) : (fitness[contender] > fitness[winner]))
+			winner = contender;
+	}
+
+	return winner;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "BoardHashSet.h"
+#include "PuzzleDefinition.h"
+#include "RandomGenerator.h"
+#include "SudokuPuzzle.h"
+
+//How parents are picked out of a genePool, and how children make it into one (see GeneticPopulation::spawnChildren)
+//	Only rankedSelection needs a fully sorted pool, the others get by with a partition, a sampled rank, or no ordering at all
+enum SelectionStrategy
+{
+	rankedSelection,		//Fully ranks both pools every generation, children replace the gene pool member of equal rank
+	tournamentSelection,	//Fittest (or least fit) of a few random members, nothing is ever sorted
+	truncationSelection,	//Only partitions the fittest 10% off from the rest (nth_element), picks uniformly within them
+	rankWeightedSelection	//Linear ranking, ranks are drawn from a precomputed CDF
+};
+
+//Memory for the boards of one or more SpecimenPools, allocated once up front and handed out a board at a time
+//	Pools that share an arena can pass boards back and forth (see SpecimenPool::takeSlot) instead of copying them
+class BoardArena
+{
+private:
+	std::vector<Cell> cells;					//Every board, back to back
+	int cellsPerBoard;
+	int boardsHandedOut;
+public:
+	BoardArena(int, int);						//Cells per board and number of boards
+	Cell *nextBoard();							//A board no pool has been given yet, there have to be some left
+};
+
+typedef std::shared_ptr<BoardArena> BoardArenaPtr;
+
+//Structure-of-arrays storage for a whole population of boards
+//	Every board lives in a single contiguous arena (shared with the other pools of the island, if there are any), with fitnesses
+//	in a parallel array, so scoring and ranking a pool sweeps through memory instead of chasing every SudokuPuzzle's own heap vectors around
+//	Slots are identified by index, ranking a pool only reorders an index array, and moving a board between pools only swaps which
+//	slot owns which board, no board is ever copied to get from one pool into another
+class SpecimenPool
+{
+private:
+	PuzzleDefinitionPtr definition;				//Shared by every board in the pool
+	int cellsPerBoard;							//sizeOfBoard * sizeOfBoard
+	BoardArenaPtr arena;						//Where the boards live, kept alive by every pool that has boards in it
+	std::vector<Cell *> slotBoards;				//The board each slot owns
+	std::vector<int> fitness;					//Fitness of the board in each slot
+	std::vector<unsigned long long> hashes;		//Zobrist hash of the board in each slot
+	std::vector<unsigned long long> storedHashes;	//Hashes of boards written by storeUnindexed, waiting for indexStored
+	BoardHashSet memberHashes;					//Every slot's hash, so a board can be checked for being in the pool already
+	std::vector<int> ranking;					//Slots ordered from most to least fit, as of the last call to rank()
+	std::vector<unsigned long long> sortKeys;	//Scratch space for rank(), (fitness, slot) packed together so the sort only moves integers
+	int bestSlot;								//Slot of the most fit board, kept up to date as slots are written
+	bool bestKnown;								//False once bestSlot was overwritten by something worse, the next getBest() looks for it again
+
+	void noteFitness(int);						//Updates bestSlot after a slot's fitness has changed
+	void setHash(int, unsigned long long);		//Replaces a slot's hash in hashes and memberHashes
+	void packSortKeys();
+public:
+	SpecimenPool();
+	SpecimenPool(PuzzleDefinitionPtr, int);		//Creates a pool with some number of (empty) slots, with an arena of its own
+	SpecimenPool(PuzzleDefinitionPtr, int, BoardArenaPtr);	//Same, with boards drawn from an arena other pools share
+
+	int size();
+	Cell *getBoard(int);						//Board stored in some slot, cellsPerBoard cells long
+	int getFitness(int);
+	void setFitness(int, int);
+	unsigned long long getHash(int);
+	bool containsHash(unsigned long long);		//Whether some slot already holds a board with the hash
+	void storeBoard(int, const Cell *);			//Copies a board into a slot, its fitness is left for evaluateAll()
+	void store(int, const SudokuPuzzle &);		//Copies a SudokuPuzzle's board and fitness into a slot
+	void storeUnindexed(int, const SudokuPuzzle &);	//Like store, but only touches the slot itself, so different slots can be written from different threads at once
+	void indexStored();							//Finishes off every slot written with storeUnindexed (which has to be all of them)
+	void takeSlot(int, SpecimenPool &, int);	//Moves the board and fitness of another pool's slot into a slot of this one (they have to share an arena)
+	SudokuPuzzle extract(int);					//Builds a standalone SudokuPuzzle out of a slot
+
+	void evaluateAll();							//Rescores every board in one sweep
+	void rank();								//Reorders the ranking by fitness, boards themselves aren't moved
+	void partition(int);						//Only moves the n most fit slots to the front of the ranking (in no particular order), in linear time
+	int getRanked(int);							//Slot holding the n-th most fit board as of the last rank() (or partition()), 0 is the best
+	int getBest();								//Slot holding the most fit board, without ranking anything
+	int tournament(int, RandomGenerator &, bool);	//Most (or, if false, least) fit of some number of randomly drawn slots
+};
\ No newline at end of file
@@ -3,148 +3,415 @@
 //This lets you call SudokuPuzzle x;
 SudokuPuzzle::SudokuPuzzle()
 {
-
+	countsValid = false;
+	hash = 0;
+	fitnessCache = NULL;
+	evaluationCounter = NULL;
 }
 
 //Parses a Sudoku file
-SudokuPuzzle::SudokuPuzzle(char *fileName)
+SudokuPuzzle::SudokuPuzzle(char *fileName, RandomGenerator &random)
 {
-	board = parseFile(fileName);
-	staticBoard = board;
-	sizeOfBoard = (int) sqrt(board.size());
-	sizeOfMacroBlock = (int) sqrt(sizeOfBoard);
+	definition = std::make_shared<PuzzleDefinition>(parseFile(fileName));
+	board = definition->getGivens();
+	sizeOfBoard = definition->getSizeOfBoard();
+	fitnessCache = NULL;
+	evaluationCounter = NULL;
 
 	//Fills in empty cells and determines conflicts
-	initCells();
+	initCells(random);
+	hash = definition->hashBoard(board.data());
 	evaluateFitness();
 }
 
 //Fills in a SudokuPuzzle based on a pre-existing initial board
-SudokuPuzzle::SudokuPuzzle(std::vector<int> existingStaticBoard)
+SudokuPuzzle::SudokuPuzzle(PuzzleDefinitionPtr existingDefinition, RandomGenerator &random)
 {
-	board = existingStaticBoard;
-	staticBoard = board;
-	sizeOfBoard = (int) sqrt(board.size());
-	sizeOfMacroBlock = (int) sqrt(sizeOfBoard);
+	definition = existingDefinition;
+	board = definition->getGivens();
+	sizeOfBoard = definition->getSizeOfBoard();
+	fitnessCache = NULL;
+	evaluationCounter = NULL;
 
 	//Fills in empty cells and determines conflicts
-	initCells();
+	initCells(random);
+	hash = definition->hashBoard(board.data());
+	evaluateFitness();
+}
+
+//Wraps a board that was filled in somewhere else (a SpecimenPool, for instance)
+SudokuPuzzle::SudokuPuzzle(PuzzleDefinitionPtr existingDefinition, const Cell *existingBoard)
+{
+	definition = existingDefinition;
+	sizeOfBoard = definition->getSizeOfBoard();
+	board.assign(existingBoard, existingBoard + sizeOfBoard * sizeOfBoard);
+	hash = definition->hashBoard(board.data());
+	fitnessCache = NULL;
+	evaluationCounter = NULL;
+
 	evaluateFitness();
 }
 
 //Swap some cell with another inside a particular macroBlock of a previously-configured puzzle
 //	0 <= origin & swap < sizeOfBoard
 //	These values correspond to the cell position within the macroBlock, 0 for top-left, sizeOfBoard-1 for bottom right
-SudokuPuzzle::SudokuPuzzle(const int block, const int origin, const int swap, SudokuPuzzle preConfig)
+SudokuPuzzle::SudokuPuzzle(const int block, const int origin, const int swap, const SudokuPuzzle &preConfig)
 {
-	int previousValue;
+	int originIndex;
+	int swapIndex;
 
-	int originRow;
-	int originCol;
-	int swapRow;
-	int swapCol;
+	//Properly initialize, this brings the conflict counts along so the swap can be scored incrementally
+	*this = preConfig;
 
-	//Properly initialize
-	sizeOfBoard = preConfig.getSizeOfBoard();
-	sizeOfMacroBlock = preConfig.getSizeOfMacroBlock();
-	board = preConfig.getBoard();
-	staticBoard = * &(preConfig.getStaticBoard());
-
-	//Math wizardry to determine what position in the single-dimension array the cells match up to
-	originCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (origin % sizeOfMacroBlock);
-	originRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (origin / sizeOfMacroBlock);
-	swapCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (swap % sizeOfMacroBlock);
-	swapRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (swap / sizeOfMacroBlock);
-
-	//Make sure everything's ok
-	assert(originCol < sizeOfBoard);
-	assert(originRow < sizeOfBoard);
-	assert(swapCol < sizeOfBoard);
-	assert(swapRow < sizeOfBoard);
-
-	//Only check if the cells can be swapped and their values are not equivalent
-	if((staticBoard[convertCoordinates(originCol, originRow, sizeOfBoard)] == 0) && (staticBoard[convertCoordinates(swapCol, swapRow, sizeOfBoard)] == 0) && (board[convertCoordinates(originCol, originRow, sizeOfBoard)] != board[convertCoordinates(swapCol, swapRow, sizeOfBoard)]))
-	{
-		previousValue = board[convertCoordinates(originCol, originRow, sizeOfBoard)];
-		board[convertCoordinates(originCol, originRow, sizeOfBoard)] = board[convertCoordinates(swapCol, swapRow, sizeOfBoard)];
-		board[convertCoordinates(swapCol, swapRow, sizeOfBoard)] = previousValue;
+	originIndex = cellIndex(block, origin);
+	swapIndex = cellIndex(block, swap);
 
-		evaluateFitness();
+	//Only swap if the cells can be swapped, otherwise the board configuration (and fitness) is the same as preConfig's
+	if(canSwap(originIndex, swapIndex))
+		swapCells(originIndex, swapIndex);
+}
+
+//Tries to give cell (a position within freeCells) one of the numbers, moving other cells to different numbers if need be (Kuhn's augmenting paths)
+//	cellOfNumber[j] is the cell numbers[j] is currently given to, or -1
+static bool matchCell(int cell, const std::vector<int> &freeCells, const int *numbers, int numNumbers, int *cellOfNumber, bool *visited, const PuzzleDefinition &definition)
+{
+	unsigned long long cellCandidates;
+
+	cellCandidates = definition.getCandidates(freeCells[cell]);
+
+	//A number nobody has taken yet is the cheap (and by far the most common) case
+	for(int j = 0; j < numNumbers; j++)
+	{
+		if((cellOfNumber[j] < 0) && (cellCandidates & (1ULL << (numbers[j] - 1))))
+		{
+			cellOfNumber[j] = cell;
+			return true;
+		}
 	}
-	else	//Otherwise the board configuration is the same, and the fitness can simply be copied instead of evaluated
+
+	for(int j = 0; j < numNumbers; j++)
 	{
-		fitness = preConfig.getFitness();
+		if(visited[j] || !(cellCandidates & (1ULL << (numbers[j] - 1))))
+			continue;
+
+		visited[j] = true;
+		if((cellOfNumber[j] < 0) || matchCell(cellOfNumber[j], freeCells, numbers, numNumbers, cellOfNumber, visited, definition))
+		{
+			cellOfNumber[j] = cell;
+			return true;
+		}
 	}
+
+	return false;
 }
 
 //Populates the board with values such that there are no conflicts within a macroBlock
-void SudokuPuzzle::initCells()
+//	Every cell also gets one of its candidates: the missing numbers are matched up to the free cells, in a random order so
+//	boards still come out different. If the puzzle has no such matching (it's unsolvable), the leftovers go in anywhere
+void SudokuPuzzle::initCells(RandomGenerator &random)
 {
-	std::vector<int> usedNumbers;
-	int currentNum;
-
-	//Could be simplified to two loops from 0-sizeOfBoard, but then you'd have to mod&divide (even more) in order to get proper grid coordinates
-	for(int i = 0; i < sizeOfMacroBlock; i++)
+	int numbers[64];				//The numbers missing from the macroBlock, in a random order
+	int cellOfNumber[64];
+	int cellOrder[64];
+	bool visited[64];
+	bool placed[64];
+	int numNumbers;
+	unsigned long long usedNumbers;	//Bit (number - 1) is set once number is in the macroBlock, no allocation needed
+
+	for(int block = 0; block < sizeOfBoard; block++)
 	{
-		for(int j = 0; j < sizeOfMacroBlock; j++)
+		//Starts off with the numbers naturally occuring in the Sudoku Puzzle
+		usedNumbers = definition->getGivenNumbers(block);
+		const std::vector<int> &freeCells = definition->getFreeCells(block);
+
+		numNumbers = 0;
+		for(int number = 1; number <= sizeOfBoard; number++)
+			if(!(usedNumbers & (1ULL << (number - 1))))
+				numbers[numNumbers++] = number;
+		for(int i = 0; i < freeCells.size(); i++)
+			cellOrder[i] = i;
+		std::shuffle(numbers, numbers + numNumbers, random);
+		std::shuffle(cellOrder, cellOrder + freeCells.size(), random);
+		std::fill(cellOfNumber, cellOfNumber + numNumbers, -1);
+
+		for(int i = 0; i < freeCells.size(); i++)
+		{
+			std::fill(visited, visited + numNumbers, false);
+			matchCell(cellOrder[i], freeCells, numbers, numNumbers, cellOfNumber, visited, *definition);
+		}
+
+		//Fills in all the rest
+		std::fill(placed, placed + freeCells.size(), false);
+		for(int j = 0; j < numNumbers; j++)
 		{
-			usedNumbers.clear();	//Reset number count
-
-			//Finds numbers naturally occuring in the Sudoku Puzzle
-			for(int k = 0; k < sizeOfMacroBlock; k++)
-				for(int l = 0; l < sizeOfMacroBlock; l++)
-					if(staticBoard[convertCoordinates(j * sizeOfMacroBlock + l, i * sizeOfMacroBlock + k, sizeOfBoard)] > 0)
-						usedNumbers.push_back(staticBoard[convertCoordinates(j * sizeOfMacroBlock + l, i * sizeOfMacroBlock + k, sizeOfBoard)]);
-
-			//Fills in all the rest
-			for(int k = 0; k < sizeOfMacroBlock; k++)
-				for(int l = 0; l < sizeOfMacroBlock; l++)
-					if(board[convertCoordinates(j * sizeOfMacroBlock + l, i * sizeOfMacroBlock + k, sizeOfBoard)] == 0)
-					{
-						do
-						{
-							currentNum = (rand() % sizeOfBoard) + 1;
-						} while(std::find(usedNumbers.begin(), usedNumbers.end(), currentNum) != usedNumbers.end());
-
-						board[convertCoordinates(j * sizeOfMacroBlock + l, i * sizeOfMacroBlock + k, sizeOfBoard)] = currentNum;
-						usedNumbers.push_back(currentNum);
-					}
+			if(cellOfNumber[j] >= 0)
+			{
+				board[freeCells[cellOfNumber[j]]] = numbers[j];
+				placed[cellOfNumber[j]] = true;
+			}
+		}
+		for(int i = 0, j = 0; i < freeCells.size(); i++)
+		{
+			if(placed[i])
+				continue;
+			while(cellOfNumber[j] >= 0)
+				j++;
+			board[freeCells[i]] = numbers[j++];
 		}
 	}
 }
 
+//Same as building a new SudokuPuzzle from the definition, except the vectors are reused instead of reallocated
+void SudokuPuzzle::regenerate(RandomGenerator &random)
+{
+	board = definition->getGivens();
+	initCells(random);
+	hash = definition->hashBoard(board.data());
+	evaluateFitness();
+}
+
+//Copying a board in is cheap, the conflict counts are only rebuilt if a swap ends up being scored on it
+void SudokuPuzzle::loadBoard(const Cell *otherBoard, int otherFitness, unsigned long long otherHash)
+{
+	board.assign(otherBoard, otherBoard + sizeOfBoard * sizeOfBoard);
+	fitness = otherFitness;
+	hash = otherHash;
+	countsValid = false;
+}
+
+void SudokuPuzzle::setFitnessCache(FitnessCache *cache)
+{
+	fitnessCache = cache;
+}
+
+void SudokuPuzzle::setEvaluationCounter(long long *counter)
+{
+	evaluationCounter = counter;
+}
+
+//buildCounts only ever sizes these the first time it runs, which for a workspace that's rarely scored can be well into a run
+void SudokuPuzzle::reserveCounts()
+{
+	rowCounts.resize(sizeOfBoard * sizeOfBoard);
+	colCounts.resize(sizeOfBoard * sizeOfBoard);
+	conflictedCells.reserve(sizeOfBoard * sizeOfBoard);
+	conflictPosition.resize(sizeOfBoard * sizeOfBoard, -1);
+}
+
 //Determines the number of conflicts in the current configuration
+//	This is the full O(n^2) evaluation, single swaps should go through swapCells instead
+//	Only the fitness is computed (with the bitmask kernel), the conflict counts are left for buildCounts since most
+//	freshly evaluated boards (random parents, for instance) never have a swap scored on them
+//	A board this population has already scored is looked up by its hash instead
 void SudokuPuzzle::evaluateFitness()
 {
-	
-	std::vector<int> foundRowNumbers;	//Number of conflicts in the current row
-	std::vector<int> foundColNumbers;
-	std::vector<int>::iterator itr;
+	countsValid = false;
+	if(evaluationCounter)	//Cache hits count too, so the count doesn't depend on what happens to be cached
+		(*evaluationCounter)++;
+	if(fitnessCache && fitnessCache->lookup(hash, fitness))
+		return;
+
+	fitness = definition->scoreBoard(board.data());
+	if(fitnessCache)
+		fitnessCache->insert(hash, fitness);
+}
 
-	fitness = 0;
+void SudokuPuzzle::buildCounts()
+{
+	if(countsValid)
+		return;
 
-	for(int i = 0; i < sizeOfBoard; i++)
-	{
-		foundRowNumbers.clear();
-		foundColNumbers.clear();
+	rowCounts.resize(sizeOfBoard * sizeOfBoard);
+	colCounts.resize(sizeOfBoard * sizeOfBoard);
 
-		for(int j = 0; j < sizeOfBoard; j++)
+	fitness = definition->countConflicts(board.data(), rowCounts.data(), colCounts.data());
+	countsValid = true;
+	if(evaluationCounter)
+		(*evaluationCounter)++;
+
+	conflictedCells.clear();
+	conflictPosition.assign(sizeOfBoard * sizeOfBoard, -1);
+	for(int i = 0; i < sizeOfBoard * sizeOfBoard; i++)
+	{
+		if(!definition->isGiven(i) && ((rowCounts[convertCoordinates(board[i] - 1, definition->getRow(i), sizeOfBoard)] > 1) || (colCounts[convertCoordinates(board[i] - 1, definition->getCol(i), sizeOfBoard)] > 1)))
 		{
-			foundRowNumbers.push_back(board[convertCoordinates(j, i, sizeOfBoard)]);
-			foundColNumbers.push_back(board[convertCoordinates(i, j, sizeOfBoard)]);
+			conflictPosition[i] = (int) conflictedCells.size();
+			conflictedCells.push_back(i);
 		}
-	
-		//Sorts the vectors so that the numbers are in order. This is used to later call std::unique to count duplicates 
-		std::sort(foundRowNumbers.begin(), foundRowNumbers.end());
-		std::sort(foundColNumbers.begin(), foundColNumbers.end());
-
-		//Count duplicates
-		for(itr = std::unique(foundRowNumbers.begin(), foundRowNumbers.end()); itr != foundRowNumbers.end(); itr++)
-			fitness++;
-		for(itr = std::unique(foundColNumbers.begin(), foundColNumbers.end()); itr != foundColNumbers.end(); itr++)
-			fitness++;
 	}
-	
+}
+
+//Change in the conflicts of a single row or column when removedValue is taken out of it and addedValue is put in
+//	Taking out a number removes a conflict if it was duplicated, putting one in adds a conflict if it was already there
+static int lineSwapDelta(const std::vector<Cell> &counts, int line, int removedValue, int addedValue, int size)
+{
+	int delta;
+
+	delta = 0;
+	if(counts[convertCoordinates(removedValue, line, size)] > 1)
+		delta--;
+	if(counts[convertCoordinates(addedValue, line, size)] > 0)
+		delta++;
+
+	return delta;
+}
+
+//Converts a macroBlock and a position within it (0 for top-left, sizeOfBoard-1 for bottom right) into an index into board
+int SudokuPuzzle::cellIndex(int block, int position)
+{
+	return definition->getCellIndex(block, position);
+}
+
+//Only cells that weren't part of the initial configuration and don't hold the same value are worth swapping
+bool SudokuPuzzle::canSwap(int originIndex, int swapIndex)
+{
+	return !definition->isGiven(originIndex) && !definition->isGiven(swapIndex) && (board[originIndex] != board[swapIndex]);
+}
+
+//Whether both values would still be candidates after swapping them, assumes canSwap
+//	Only mutation sticks to these, crossover doesn't, since some boards can only be reached by passing through illegal ones
+bool SudokuPuzzle::isLegalSwap(int originIndex, int swapIndex)
+{
+	return (definition->getCandidates(originIndex) & (1ULL << (board[swapIndex] - 1))) && (definition->getCandidates(swapIndex) & (1ULL << (board[originIndex] - 1)));
+}
+
+//Only scoring a swap counts as an evaluation, making one (which works out the same delta again) doesn't
+//	Assumes canSwap(originIndex, swapIndex)
+int SudokuPuzzle::evaluateSwap(int originIndex, int swapIndex)
+{
+	buildCounts();
+	if(evaluationCounter)
+		(*evaluationCounter)++;
+
+	return computeSwapDelta(originIndex, swapIndex);
+}
+
+//Scores a swap by only looking at the (at most) two rows and two columns it touches
+int SudokuPuzzle::computeSwapDelta(int originIndex, int swapIndex)
+{
+	int originValue;
+	int swapValue;
+	int originRow;
+	int originCol;
+	int swapRow;
+	int swapCol;
+	int delta;
+
+	originValue = board[originIndex] - 1;
+	swapValue = board[swapIndex] - 1;
+	originRow = definition->getRow(originIndex);
+	originCol = definition->getCol(originIndex);
+	swapRow = definition->getRow(swapIndex);
+	swapCol = definition->getCol(swapIndex);
+	delta = 0;
+
+	//Swapping within a single row or column doesn't change the numbers in it
+	if(originRow != swapRow)
+	{
+		delta += lineSwapDelta(rowCounts, originRow, originValue, swapValue, sizeOfBoard);
+		delta += lineSwapDelta(rowCounts, swapRow, swapValue, originValue, sizeOfBoard);
+	}
+	if(originCol != swapCol)
+	{
+		delta += lineSwapDelta(colCounts, originCol, originValue, swapValue, sizeOfBoard);
+		delta += lineSwapDelta(colCounts, swapCol, swapValue, originValue, sizeOfBoard);
+	}
+
+	return delta;
+}
+
+//Swaps two cells, keeping rowCounts, colCounts and fitness up to date without a full evaluateFitness()
+//	Assumes canSwap(originIndex, swapIndex)
+void SudokuPuzzle::swapCells(int originIndex, int swapIndex)
+{
+	int originValue;
+	int swapValue;
+	int delta;
+
+	buildCounts();
+	delta = computeSwapDelta(originIndex, swapIndex);
+	fitness += delta;
+	hashSwap(originIndex, swapIndex);
+
+	originValue = board[originIndex] - 1;
+	swapValue = board[swapIndex] - 1;
+
+	rowCounts[convertCoordinates(originValue, definition->getRow(originIndex), sizeOfBoard)]--;
+	rowCounts[convertCoordinates(swapValue, definition->getRow(originIndex), sizeOfBoard)]++;
+	rowCounts[convertCoordinates(swapValue, definition->getRow(swapIndex), sizeOfBoard)]--;
+	rowCounts[convertCoordinates(originValue, definition->getRow(swapIndex), sizeOfBoard)]++;
+	colCounts[convertCoordinates(originValue, definition->getCol(originIndex), sizeOfBoard)]--;
+	colCounts[convertCoordinates(swapValue, definition->getCol(originIndex), sizeOfBoard)]++;
+	colCounts[convertCoordinates(swapValue, definition->getCol(swapIndex), sizeOfBoard)]--;
+	colCounts[convertCoordinates(originValue, definition->getCol(swapIndex), sizeOfBoard)]++;
+
+	board[originIndex] = swapValue + 1;
+	board[swapIndex] = originValue + 1;
+
+	//Other cells' conflicts only change in lines where a number just stopped (count is down to 1) or started (count is up to 2) being duplicated
+	if(definition->getRow(originIndex) != definition->getRow(swapIndex))
+	{
+		refreshLineConflicts(rowCounts, true, definition->getRow(originIndex), originValue, 1);
+		refreshLineConflicts(rowCounts, true, definition->getRow(originIndex), swapValue, 2);
+		refreshLineConflicts(rowCounts, true, definition->getRow(swapIndex), swapValue, 1);
+		refreshLineConflicts(rowCounts, true, definition->getRow(swapIndex), originValue, 2);
+	}
+	if(definition->getCol(originIndex) != definition->getCol(swapIndex))
+	{
+		refreshLineConflicts(colCounts, false, definition->getCol(originIndex), originValue, 1);
+		refreshLineConflicts(colCounts, false, definition->getCol(originIndex), swapValue, 2);
+		refreshLineConflicts(colCounts, false, definition->getCol(swapIndex), swapValue, 1);
+		refreshLineConflicts(colCounts, false, definition->getCol(swapIndex), originValue, 2);
+	}
+	updateConflictStatus(originIndex);
+	updateConflictStatus(swapIndex);
+}
+
+//Each of the two cells trades the key of its old number for the key of its new one
+void SudokuPuzzle::hashSwap(int originIndex, int swapIndex)
+{
+	hash ^= definition->getZobristKey(originIndex, board[originIndex]) ^ definition->getZobristKey(originIndex, board[swapIndex]);
+	hash ^= definition->getZobristKey(swapIndex, board[swapIndex]) ^ definition->getZobristKey(swapIndex, board[originIndex]);
+}
+
+//Adds a free cell to (or takes it out of) conflictedCells to match the conflict counts
+void SudokuPuzzle::updateConflictStatus(int index)
+{
+	bool conflicted;
+	int position;
+
+	conflicted = !definition->isGiven(index) && isConflicted(index);
+	position = conflictPosition[index];
+
+	if(conflicted && (position < 0))
+	{
+		conflictPosition[index] = (int) conflictedCells.size();
+		conflictedCells.push_back(index);
+	}
+	else if(!conflicted && (position >= 0))
+	{
+		//The last cell takes its place, so removal doesn't shift anything
+		conflictedCells[position] = conflictedCells.back();
+		conflictPosition[conflictedCells[position]] = position;
+		conflictedCells.pop_back();
+		conflictPosition[index] = -1;
+	}
+}
+
+//Re-checks every cell of a row (or column) that holds value, if the line now has triggerCount of that value
+void SudokuPuzzle::refreshLineConflicts(const std::vector<Cell> &counts, bool isRow, int line, int value, int triggerCount)
+{
+	int index;
+
+	if(counts[convertCoordinates(value, line, sizeOfBoard)] != triggerCount)
+		return;
+
+	for(int i = 0; i < sizeOfBoard; i++)
+	{
+		index = isRow ? convertCoordinates(i, line, sizeOfBoard) : convertCoordinates(line, i, sizeOfBoard);
+		if(board[index] == value + 1)
+			updateConflictStatus(index);
+	}
 }
 
 //Allows SudokuPuzzles to be compared to each other based off of fitness
@@ -153,45 +420,51 @@ bool SudokuPuzzle::operator<(const SudokuPuzzle& other)
 	return (fitness < other.fitness);
 }
 
-void SudokuPuzzle::randomize(int numMutations)
+//Swaps random pairs of cells within random macroBlocks
+//	If the conflict counts are up to date each swap is scored incrementally, otherwise the board is rescored once at the end
+//	With up to date counts, most swaps also start from a conflicted cell, since moving a conflict-free one rarely helps
+void SudokuPuzzle::randomize(int numMutations, RandomGenerator &random)
 {
-	int previousValue;
 	int block;
-	int origin;
-	int swap;
-	int originCol;
-	int originRow;
-	int swapCol;
-	int swapRow;
+	int originIndex;
+	int swapIndex;
 
 	for(int i = 0; i < numMutations; i++)
 	{
-		block = rand() % sizeOfBoard;
-		origin = rand() % sizeOfBoard;
-		swap = rand() % sizeOfBoard;
-
-		//Math wizardry to determine what position in the single-dimension array the cells match up to
-		originCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (origin % sizeOfMacroBlock);
-		originRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (origin / sizeOfMacroBlock);
-		swapCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (swap % sizeOfMacroBlock);
-		swapRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (swap / sizeOfMacroBlock);
-
-		//Make sure everything's ok
-		assert(originCol < sizeOfBoard);
-		assert(originRow < sizeOfBoard);
-		assert(swapCol < sizeOfBoard);
-		assert(swapRow < sizeOfBoard);
-
-		//Only check if the cells can be swapped and their values are not equivalent
-		if((staticBoard[convertCoordinates(originCol, originRow, sizeOfBoard)] == 0) && (staticBoard[convertCoordinates(swapCol, swapRow, sizeOfBoard)] == 0) && (board[convertCoordinates(originCol, originRow, sizeOfBoard)] != board[convertCoordinates(swapCol, swapRow, sizeOfBoard)]))
+		//Only the free cells are drawn from, constraint propagation can leave very few of them
+		if(countsValid && !conflictedCells.empty() && (random.nextInt(100) < conflictBiasPercent))
+		{
+			originIndex = conflictedCells[random.nextInt(conflictedCells.size())];
+			block = definition->getBlock(originIndex);
+		}
+		else
 		{
-			previousValue = board[convertCoordinates(originCol, originRow, sizeOfBoard)];
-			board[convertCoordinates(originCol, originRow, sizeOfBoard)] = board[convertCoordinates(swapCol, swapRow, sizeOfBoard)];
-			board[convertCoordinates(swapCol, swapRow, sizeOfBoard)] = previousValue;
+			block = random.nextInt(sizeOfBoard);
+			originIndex = -1;
+		}
+
+		const std::vector<int> &freeCells = definition->getFreeCells(block);
+		if(freeCells.size() < 2)
+			continue;
+		if(originIndex < 0)
+			originIndex = freeCells[random.nextInt(freeCells.size())];
+		swapIndex = freeCells[random.nextInt(freeCells.size())];
+
+		//Only swap if the cells can be swapped, their values are not equivalent, and both stay candidates
+		if(canSwap(originIndex, swapIndex) && isLegalSwap(originIndex, swapIndex))
+		{
+			if(countsValid)
+				swapCells(originIndex, swapIndex);
+			else
+			{
+				hashSwap(originIndex, swapIndex);
+				std::swap(board[originIndex], board[swapIndex]);
+			}
 		}
 	}
 
-	evaluateFitness();
+	if(!countsValid)
+		evaluateFitness();
 }
 
 //Prints the board configuration
@@ -203,59 +476,134 @@ void SudokuPuzzle::printBoard()
 		{
 			if(board[convertCoordinates(j, i, sizeOfBoard)] < 10)
 				std::cout << " ";
-			std::cout << board[convertCoordinates(j, i, sizeOfBoard)] << " ";
+			std::cout << (int) board[convertCoordinates(j, i, sizeOfBoard)] << " ";
 		}
 		std::cout << std::endl;
 	}
 }
 
+//Puts the value swap at position origin of a macroBlock, by swapping it with the cell that currently holds swap
 void SudokuPuzzle::replaceCell(int block, int origin, int swap)
 {
-	int originCol;
-	int originRow;
-	int swapRow;
-	int swapCol;
-	int previousValue;
+	applyMove(getReplaceMove(block, origin, swap));
+}
+
+SwapMove SudokuPuzzle::getSwapMove(int block, int origin, int swap)
+{
+	SwapMove move;
 
-	originCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (origin % sizeOfMacroBlock);
-	originRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (origin / sizeOfMacroBlock);
+	move.originIndex = cellIndex(block, origin);
+	move.swapIndex = cellIndex(block, swap);
+
+	if(!canSwap(move.originIndex, move.swapIndex))
+		move.originIndex = -1;
+
+	return move;
+}
+
+SwapMove SudokuPuzzle::getCellSwapMove(int originIndex, int swapIndex)
+{
+	SwapMove move;
 
+	move.originIndex = canSwap(originIndex, swapIndex) ? originIndex : -1;
+	move.swapIndex = swapIndex;
+
+	return move;
+}
+
+SwapMove SudokuPuzzle::getReplaceMove(int block, int origin, int value)
+{
+	SwapMove move;
+
+	move.originIndex = -1;
+	move.swapIndex = -1;
+
+	//Finds the cell of the macroBlock that currently holds value
 	for(int i = 0; i < sizeOfBoard; i++)
 	{
-		if(board[convertCoordinates((block % sizeOfMacroBlock) * sizeOfMacroBlock + i % sizeOfMacroBlock, (block / sizeOfMacroBlock) * sizeOfMacroBlock + i / sizeOfMacroBlock, sizeOfBoard)] == swap)
+		if(board[cellIndex(block, i)] == value)
 		{
-			swapCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (i % sizeOfMacroBlock);
-			swapRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (i / sizeOfMacroBlock);
+			move.swapIndex = cellIndex(block, i);
 			break;
 		}
-
 	}
 
-	//Todo: 
-	if((staticBoard[convertCoordinates(originCol, originRow, sizeOfBoard)] == 0) && (staticBoard[convertCoordinates(swapCol, swapRow, sizeOfBoard)] == 0) && (board[convertCoordinates(originCol, originRow, sizeOfBoard)] != board[convertCoordinates(swapCol, swapRow, sizeOfBoard)]))
-	{
-		previousValue = board[convertCoordinates(originCol, originRow, sizeOfBoard)];
-		board[convertCoordinates(originCol, originRow, sizeOfBoard)] = board[convertCoordinates(swapCol, swapRow, sizeOfBoard)];
-		board[convertCoordinates(swapCol, swapRow, sizeOfBoard)] = previousValue;
-		evaluateFitness();
-	}
+	if((move.swapIndex >= 0) && canSwap(cellIndex(block, origin), move.swapIndex))
+		move.originIndex = cellIndex(block, origin);
+
+	return move;
+}
+
+int SudokuPuzzle::evaluateMove(const SwapMove &move)
+{
+	if(move.originIndex < 0)
+		return 0;
+
+	return evaluateSwap(move.originIndex, move.swapIndex);
+}
+
+void SudokuPuzzle::applyMove(const SwapMove &move)
+{
+	if(move.originIndex >= 0)
+		swapCells(move.originIndex, move.swapIndex);
+}
+
+//Moves have to be undone in the reverse order they were applied in
+void SudokuPuzzle::undoMove(const SwapMove &move)
+{
+	applyMove(move);
+}
+
+//Returns how much the fitness would change if two cells of a macroBlock were swapped, 0 if they can't be swapped
+int SudokuPuzzle::getSwapDelta(int block, int origin, int swap)
+{
+	return evaluateMove(getSwapMove(block, origin, swap));
 }
 
 int SudokuPuzzle::getCellAt(int block, int x)
 {
-	int originCol;
-	int originRow;
+	return board[cellIndex(block, x)];
+}
+
+//Needs the conflict counts, so the first call on a freshly evaluated board builds them
+bool SudokuPuzzle::isConflicted(int index)
+{
+	int value;
+
+	buildCounts();
+	value = board[index] - 1;
+
+	return (rowCounts[convertCoordinates(value, definition->getRow(index), sizeOfBoard)] > 1) || (colCounts[convertCoordinates(value, definition->getCol(index), sizeOfBoard)] > 1);
+}
+
+const std::vector<int> &SudokuPuzzle::getConflictedCells()
+{
+	buildCounts();
+
+	return conflictedCells;
+}
 
-	originCol = (block % sizeOfMacroBlock) * sizeOfMacroBlock + (x % sizeOfMacroBlock);
-	originRow = (block / sizeOfMacroBlock) * sizeOfMacroBlock + (x / sizeOfMacroBlock);
-	return board[convertCoordinates(originCol, originRow, sizeOfBoard)];
+//Whether a move could possibly lower the fitness, without scoring it
+//	Taking a number out of a line only removes a conflict if it was duplicated there, so a swap between two cells that aren't
+//	part of any conflict can never help
+bool SudokuPuzzle::canImprove(const SwapMove &move)
+{
+	if(move.originIndex < 0)
+		return false;
+
+	return isConflicted(move.originIndex) || isConflicted(move.swapIndex);
 }
 
-int SudokuPuzzle::getFitness()
+int SudokuPuzzle::getFitness() const
 {
 	return fitness;
 }
 
+unsigned long long SudokuPuzzle::getHash() const
+{
+	return hash;
+}
+
 int SudokuPuzzle::getSizeOfBoard()
 {
 	return sizeOfBoard;
@@ -263,15 +611,20 @@ int SudokuPuzzle::getSizeOfBoard()
 
 int SudokuPuzzle::getSizeOfMacroBlock()
 {
-	return sizeOfMacroBlock;
+	return definition->getSizeOfMacroBlock();
 }
 
-std::vector<int> SudokuPuzzle::getBoard()
+const std::vector<Cell> &SudokuPuzzle::getBoard() const
 {
 	return board;
 }
 
-std::vector<int> SudokuPuzzle::getStaticBoard()
+const std::vector<Cell> &SudokuPuzzle::getStaticBoard()
+{
+	return definition->getGivens();
+}
+
+PuzzleDefinitionPtr SudokuPuzzle::getDefinition()
 {
-	return staticBoard;
+	return definition;
 }
\ No newline at end of file
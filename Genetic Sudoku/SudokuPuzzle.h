@@ -1,36 +1,89 @@
 #pragma once
 
+#include <algorithm>
 #include <stdio.h>
 #include <vector>
 #include "CSVReader.h"
+#include "PuzzleDefinition.h"
+#include "FitnessCache.h"
+#include "RandomGenerator.h"
 #include "Utils.h"
 
+//Percent of the mutations in randomize that start from a conflicted cell (when there are any) rather than any free cell
+#define conflictBiasPercent 75
+
+//A swap of two cells within the same macroBlock, as indices into the board
+//	Swaps are their own inverse, so undoing a move is just applying it again
+struct SwapMove
+{
+	int originIndex;				//-1 if the move does nothing (the cells couldn't be swapped)
+	int swapIndex;
+};
+
 class SudokuPuzzle
 {
+	friend class Benchmark;			//Times the private evaluation and setup routines directly
 private:
-	int sizeOfMacroBlock;			//length of sides of each "macroBlock", or cell of a Sudoku Puzzle
 	int sizeOfBoard;				//the n of an n x n Sudoku Puzzle
-	std::vector<int> board;			//Representation of the current configuration of the Sudoku board
-	std::vector<int> staticBoard;	//Representation of the initial configuration of the Sudoku board
+	std::vector<Cell> board;		//Representation of the current configuration of the Sudoku board, one byte per cell
+	PuzzleDefinitionPtr definition;	//The initial configuration of the Sudoku board, shared with every other SudokuPuzzle solving it
 	int fitness;					//How many total row and column-wise conflicts the configuration has
+	std::vector<Cell> rowCounts;	//How many times each number occurs in each row, indexed by convertCoordinates(number - 1, row, sizeOfBoard)
+	std::vector<Cell> colCounts;	//How many times each number occurs in each column, indexed the same way as rowCounts
+	bool countsValid;				//Whether rowCounts and colCounts match the board, they're only built once a swap needs them
+	std::vector<int> conflictedCells;	//Free cells that share their value with another cell of their row or column, kept up to date along with the counts
+	std::vector<int> conflictPosition;	//For each board index, its position in conflictedCells (-1 if it isn't in there)
+	unsigned long long hash;		//Zobrist hash of the board, updated along with every swap
+	FitnessCache *fitnessCache;		//Where full evaluations are looked up first, if anywhere (it belongs to the GeneticPopulation)
+	long long *evaluationCounter;	//Bumped for every fitness evaluation (full, or of a single swap), if set (see IslandMetrics)
 
-	void initCells();				//Used to set up an initial configuration after reading in a file
-	void evaluateFitness();			//Evaluates the configuration's number of conflicts
+	void initCells(RandomGenerator &);	//Used to set up an initial configuration after reading in a file, each cell gets one of its candidates
+	void evaluateFitness();			//Evaluates the configuration's number of conflicts from scratch, invalidating rowCounts and colCounts
+	void buildCounts();				//Rebuilds rowCounts and colCounts if they're out of date
+	int cellIndex(int, int);		//Converts a (macroBlock, position within macroBlock) pair into an index into board
+	bool canSwap(int, int);			//Whether the cells at the two board indices can be swapped (neither is static and their values differ)
+	bool isLegalSwap(int, int);		//Whether swapping the cells at the two board indices keeps both of them on one of their candidates
+	int evaluateSwap(int, int);		//Change in fitness that swapping the cells at the two board indices would cause, the board is left untouched
+	int computeSwapDelta(int, int);	//What evaluateSwap works out, without counting it as an evaluation, assumes rowCounts and colCounts are built
+	void swapCells(int, int);		//Swaps the cells at the two board indices and updates the fitness incrementally
+	void hashSwap(int, int);		//Updates the hash for a swap of the cells at the two board indices, before the board itself is changed
+	void updateConflictStatus(int);	//Puts the cell at some board index in (or takes it out of) conflictedCells
+	void refreshLineConflicts(const std::vector<Cell> &, bool, int, int, int);	//Updates the cells of a row/column holding some value, if that value's count just crossed the duplicate threshold
 public:
 	SudokuPuzzle();					//Empty constructor so that empty objects can be created
-	SudokuPuzzle(char *);			//Creates a board from some valid .csv representation of a Sudoku file
-	SudokuPuzzle(std::vector<int>);				//Creates a board from an initial Sudoku configuration
-	SudokuPuzzle(const int, const int, const int, SudokuPuzzle);	//Creates an object by swapping around two cells within a macroBlock of an existing Sudoku Puzzle
+	SudokuPuzzle(char *, RandomGenerator &);	//Creates a board from some valid .csv representation of a Sudoku file
+	SudokuPuzzle(PuzzleDefinitionPtr, RandomGenerator &);	//Creates a random board from a (shared) initial Sudoku configuration
+	SudokuPuzzle(PuzzleDefinitionPtr, const Cell *);	//Creates an object out of an existing (filled in) board
+	SudokuPuzzle(const int, const int, const int, const SudokuPuzzle &);	//Creates an object by swapping around two cells within a macroBlock of an existing Sudoku Puzzle
 	
 	bool operator<(const SudokuPuzzle&);	//Used for sorting comparisons
 	//Gets for member variables
 	void replaceCell(int, int, int);
 	int getCellAt(int, int);
-	void randomize(int);
+	int getSwapDelta(int, int, int);	//"What-if" query: change in fitness if two cells within a macroBlock were swapped, without mutating the board
+	void randomize(int, RandomGenerator &);
+	void regenerate(RandomGenerator &);				//Throws away the current configuration and fills in a new random one, reusing the existing storage
+	void loadBoard(const Cell *, int, unsigned long long);	//Copies in some other board whose fitness and hash are already known, reusing the existing storage
+	void setFitnessCache(FitnessCache *);		//Full evaluations check (and fill in) this cache from now on, NULL for none
+	void setEvaluationCounter(long long *);		//Counts every evaluation into this from now on, NULL for none
+	void reserveCounts();						//Sizes the incremental scoring buffers up front, so a workspace never allocates once it's in use
+
+	//Move API, lets callers try out swaps in place instead of copying whole puzzles
+	SwapMove getSwapMove(int, int, int);		//Move that swaps two positions within a macroBlock
+	SwapMove getReplaceMove(int, int, int);		//Move that puts some value at a position within a macroBlock (see replaceCell)
+	SwapMove getCellSwapMove(int, int);			//Move that swaps the cells at two board indices (of the same macroBlock)
+	int evaluateMove(const SwapMove &);			//Change in fitness the move would cause, the board is left untouched
+	void applyMove(const SwapMove &);
+	void undoMove(const SwapMove &);
 	int getSizeOfMacroBlock();
 	int getSizeOfBoard();
-	int getFitness();
-	std::vector<int> getBoard();
-	std::vector<int> getStaticBoard();
+	int getFitness() const;
+	unsigned long long getHash() const;
+	bool isConflicted(int);						//Whether the cell at some board index shares its value with another cell of its row or column
+	const std::vector<int> &getConflictedCells();	//Every free cell that isConflicted, in no particular order
+	bool canImprove(const SwapMove &);			//False if the move can't possibly lower the fitness (neither cell is in a conflict)
+	const std::vector<Cell> &getBoard() const;
+	const std::vector<Cell> &getStaticBoard();
+	PuzzleDefinitionPtr getDefinition();
 	void printBoard();
 };
\ No newline at end of file
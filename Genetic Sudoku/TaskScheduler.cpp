@@ -0,0 +1,186 @@
+#include "TaskScheduler.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+TaskScheduler::TaskScheduler(int numWorkers, bool pin)
+{
+	stopping = false;
+	queuedTasks = 0;
+	pendingTasks = 0;
+	nextQueue = 0;
+	pinThreads = pin;
+
+	for(int i = 0; i < numWorkers; i++)
+		queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+
+	for(int i = 0; i < numWorkers; i++)
+	{
+		workers.push_back(std::thread(&TaskScheduler::workerLoop, this, i));
+		workerIds.push_back(workers.back().get_id());
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	waitIdle();
+
+	{
+		std::lock_guard<std::mutex> lock(idleMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+
+	for(int i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+//Threads are pinned round robin across the cores the OS reports
+//	With the OS's first-touch page placement, anything a pinned worker allocates ends up in memory local to its core's NUMA node
+void TaskScheduler::pinCurrentThread(int worker)
+{
+	int numCores;
+
+	numCores = std::thread::hardware_concurrency();
+	if(numCores <= 0)
+		return;
+
+#if defined(_WIN32)
+	SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR) 1) << (worker % numCores % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+	cpu_set_t cpus;
+
+	CPU_ZERO(&cpus);
+	CPU_SET(worker % numCores, &cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif
+}
+
+void TaskScheduler::workerLoop(int worker)
+{
+	std::function<void()> task;
+
+	if(pinThreads)
+		pinCurrentThread(worker);
+
+	while(true)
+	{
+		if(popTask(worker, task))
+		{
+			runTask(task);
+			continue;
+		}
+
+		//Nothing to run or steal, sleep until something is submitted
+		std::unique_lock<std::mutex> lock(idleMutex);
+		workAvailable.wait(lock, [this] { return stopping || (queuedTasks > 0); });
+		if(stopping && (queuedTasks == 0))
+			return;
+	}
+}
+
+bool TaskScheduler::popTask(int worker, std::function<void()> &task)
+{
+	WorkerQueue *queue;
+
+	//Own deque, newest first
+	if(worker >= 0)
+	{
+		queue = queues[worker].get();
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if(!queue->tasks.empty())
+		{
+			task = std::move(queue->tasks.back());
+			queue->tasks.pop_back();
+			queuedTasks--;
+			return true;
+		}
+	}
+
+	//Steal the oldest task from somebody else, starting with the next worker over so thieves spread out
+	for(int i = 1; i <= queues.size(); i++)
+	{
+		queue = queues[(worker + i + queues.size()) % queues.size()].get();
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if(!queue->tasks.empty())
+		{
+			task = std::move(queue->tasks.front());
+			queue->tasks.pop_front();
+			queuedTasks--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TaskScheduler::runTask(std::function<void()> &task)
+{
+	task();
+	task = nullptr;
+
+	if(--pendingTasks == 0)
+	{
+		std::lock_guard<std::mutex> lock(idleMutex);
+		allDone.notify_all();
+	}
+}
+
+int TaskScheduler::currentWorker()
+{
+	for(int i = 0; i < workerIds.size(); i++)
+		if(workerIds[i] == std::this_thread::get_id())
+			return i;
+
+	return -1;
+}
+
+void TaskScheduler::enqueue(std::function<void()> task, bool atFront)
+{
+	int worker;
+
+	worker = currentWorker();
+	if(worker < 0)
+		worker = nextQueue++ % (int) queues.size();
+
+	pendingTasks++;
+	{
+		std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+		if(atFront)
+			queues[worker]->tasks.push_front(std::move(task));
+		else
+			queues[worker]->tasks.push_back(std::move(task));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(idleMutex);
+		queuedTasks++;
+	}
+	workAvailable.notify_one();
+}
+
+void TaskScheduler::submit(std::function<void()> task)
+{
+	enqueue(std::move(task), false);
+}
+
+//Workers run their own deque from the back, so the front is the last thing they'll get to
+void TaskScheduler::submitDeferred(std::function<void()> task)
+{
+	enqueue(std::move(task), true);
+}
+
+void TaskScheduler::waitIdle()
+{
+	std::unique_lock<std::mutex> lock(idleMutex);
+	allDone.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+int TaskScheduler::getNumWorkers()
+{
+	return (int) workers.size();
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Work-stealing thread pool
+//	Every worker has its own deque of tasks. A worker runs tasks off of the back of its own deque (most recently submitted first,
+//	which keeps a task's data warm in that core's cache), and only when it runs out steals from the front of somebody else's.
+//	Tasks submitted from inside a task go to the submitting worker's deque, so work that resubmits itself tends to stay on one core.
+class TaskScheduler
+{
+private:
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;	//One per worker
+	std::vector<std::thread> workers;
+	std::vector<std::thread::id> workerIds;				//Used to find out which worker (if any) is submitting a task
+	std::atomic<bool> stopping;
+	std::atomic<int> queuedTasks;						//Tasks sitting in some deque
+	std::atomic<int> pendingTasks;						//Tasks that are queued or running
+	std::atomic<int> nextQueue;							//Round robin for tasks submitted from outside the pool
+	std::mutex idleMutex;
+	std::condition_variable workAvailable;				//Idle workers sleep on this
+	std::condition_variable allDone;					//waitIdle sleeps on this
+	bool pinThreads;
+
+	void workerLoop(int);
+	bool popTask(int, std::function<void()> &);			//Own deque first, then steals
+	void runTask(std::function<void()> &);
+	void enqueue(std::function<void()>, bool);			//Puts a task at the back (or front) of the submitting worker's deque
+	int currentWorker();								//Index of the calling worker, -1 if it isn't one
+	static void pinCurrentThread(int);					//Pins the calling thread to some core
+public:
+	TaskScheduler(int, bool);							//Number of workers and whether to pin each one to its own core
+	~TaskScheduler();									//Finishes every pending task, then joins the workers
+
+	void submit(std::function<void()>);
+	void submitDeferred(std::function<void()>);			//Like submit, but the task runs after everything already queued on this worker,
+														//	used by tasks that reschedule themselves so they take turns with the others
+	void waitIdle();									//Blocks until every submitted task has finished
+	int getNumWorkers();
+};
\ No newline at end of file
@@ -1,7 +1,19 @@
 #pragma once
 
+//A single cell of a Sudoku board (or a count of numbers in a row/column), boards go up to 36x36 so a byte is plenty
+typedef unsigned char Cell;
+
 /* A handy formula to index into a single dimensional array as if it were a 2D array with row-length size */
 inline int convertCoordinates(int x, int y, int size)
 {
 	return (x + (y * size));
+}
+
+/* Number of set bits, done with shifts and masks so it doesn't depend on the CPU having a popcount instruction */
+inline int countBits(unsigned long long value)
+{
+	value = value - ((value >> 1) & 0x5555555555555555ULL);
+	value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+	value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int) ((value * 0x0101010101010101ULL) >> 56);
 }
\ No newline at end of file